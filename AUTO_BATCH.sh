@@ -7,6 +7,14 @@
 #SBATCH --output=final_nutrient_sims_longer_50.stdout
 #SBATCH --job-name="final_nutrient_sims_longer_50"
 #SBATCH -p fast.q 
-export OMP_NUM_THREADS 12
-mkdir Animate_final_nutrient_sims_longer_50
-./program Animate_final_nutrient_sims_longer_50 -Budding 0 -nutrient_depletion 1 -start_from_four 0 -division 2
+#SBATCH --signal=B:USR1@300
+#threads: one per requested core, pinned, no nested teams
+export OMP_NUM_THREADS=$SLURM_CPUS_PER_TASK
+export OMP_PROC_BIND=close
+export OMP_PLACES=cores
+export OMP_MAX_ACTIVE_LEVELS=1
+mkdir -p Animate_final_nutrient_sims_longer_50
+if [ -f Animate_final_nutrient_sims_longer_50/checkpoint.done ]; then echo "Animate_final_nutrient_sims_longer_50 already finished"; exit 0; fi
+RESTART=""
+if [ -f Animate_final_nutrient_sims_longer_50/checkpoint.bin ]; then RESTART="-restart Animate_final_nutrient_sims_longer_50/checkpoint.bin"; fi
+exec ./program Animate_final_nutrient_sims_longer_50 $RESTART -Budding 0 -nutrient_depletion 1 -start_from_four 0 -division 2
@@ -7,7 +7,18 @@
 #SBATCH --output=Mixed_init_5.stdout
 #SBATCH --job-name="Mixed_init_5"
 #SBATCH -p short
+#five minutes before the time limit the program is told to
+#checkpoint, resubmitting this script carries on from there,
+#a finished run leaves checkpoint.done and is not run again
+#SBATCH --signal=B:USR1@300
 
-set OMP_NUM_THREADS=12
-mkdir Mixed_init_5
-./program Mixed_init_5
+#threads: one per requested core, pinned, no nested teams
+export OMP_NUM_THREADS=$SLURM_CPUS_PER_TASK
+export OMP_PROC_BIND=close
+export OMP_PLACES=cores
+export OMP_MAX_ACTIVE_LEVELS=1
+mkdir -p Mixed_init_5
+if [ -f Mixed_init_5/checkpoint.done ]; then echo "Mixed_init_5 already finished"; exit 0; fi
+RESTART=""
+if [ -f Mixed_init_5/checkpoint.bin ]; then RESTART="-restart Mixed_init_5/checkpoint.bin"; fi
+exec ./program Mixed_init_5 $RESTART
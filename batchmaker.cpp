@@ -121,10 +121,21 @@ int main(int argc, char* argv[]) {
 	ofs << "#SBATCH --output=" << test << ".stdout\n";
 	ofs << "#SBATCH --job-name=\"" << test << "\"\n";
 	ofs << "#SBATCH -p " << p << " \n";
-
-	ofs << "export OMP_NUM_THREADS " << cores << "\n";
-	ofs << "mkdir " << "Animate_" << test << "\n";
-	ofs << "./program " << "Animate_" << test; 
+	//five minutes before the time limit the program is told to
+	//checkpoint, resubmitting the script carries on from there,
+	//a finished run leaves checkpoint.done and is not run again
+	ofs << "#SBATCH --signal=B:USR1@300\n";
+
+	//threads: one per requested core, pinned, no nested teams
+	ofs << "export OMP_NUM_THREADS=" << cores << "\n";
+	ofs << "export OMP_PROC_BIND=close\n";
+	ofs << "export OMP_PLACES=cores\n";
+	ofs << "export OMP_MAX_ACTIVE_LEVELS=1\n";
+	ofs << "mkdir -p " << "Animate_" << test << "\n";
+	ofs << "if [ -f Animate_" << test << "/checkpoint.done ]; then echo \"Animate_" << test << " already finished\"; exit 0; fi\n";
+	ofs << "RESTART=\"\"\n";
+	ofs << "if [ -f Animate_" << test << "/checkpoint.bin ]; then RESTART=\"-restart Animate_" << test << "/checkpoint.bin\"; fi\n";
+	ofs << "exec ./program " << "Animate_" << test << " $RESTART"; 
 	for (unsigned int i = 0; i < parameter_values.size(); i++ ) { 
 		ofs << " " << parameter_names.at(i) << " " << parameter_values.at(i);
 	}
@@ -24,79 +24,81 @@ using namespace std;
 //Public Member Functions for Cell.cpp
 
 //Constructor for simulations starting with a single founder
-Cell::Cell(shared_ptr<Colony> my_colony, int rank, Coord cell_center,double init_radius, double div_site){
+Cell::Cell(Colony* my_colony, int rank, Coord cell_center,double init_radius, double div_site){
     this->my_colony = my_colony;
+    this->my_store = &my_colony->get_store();
     this->rank = rank;
-    this->cell_center = cell_center;
-    this->max_radius = average_radius + average_radius*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0);
-    this->curr_radius = max_radius;
-    this->at_max_size = true;
+    this->random_events = 0;
+    Random_Stream draws = this->next_random_stream();
+    this->slot = my_store->add_cell();
+    my_store->x[slot] = cell_center.get_X();
+    my_store->y[slot] = cell_center.get_Y();
+    my_store->max_radius[slot] = average_radius + average_radius*(draws.uniform(-10.0,10.0)/100.0);
+    my_store->radius[slot] = my_store->max_radius[slot];
+    my_store->at_max_size[slot] = true;
     //curr_force set in function
     //bin_id set in function
     this->age = 0;
-    this->T_age = 0;
-    this->my_G1_length = average_G1_mother + average_G1_mother*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0); 
-    this->my_Budded_phase = average_budded_period_mother + average_budded_period_mother*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0);
+    my_store->T_age[slot] = 0;
+    this->my_G1_length = average_G1_mother + average_G1_mother*(draws.uniform(-10.0,10.0)/100.0); 
+    this->my_Budded_phase = average_budded_period_mother + average_budded_period_mother*(draws.uniform(-10.0,10.0)/100.0);
     //reset this after every mitosis because this determines the
     // length of time the next daughterwill spend on the mother cell
-    this->G1 = true;
-    this->G2 = false;
-    this->S = false;
-    this->M = false;
-    this->growth_rate = max_radius/(my_G1_length);
-    this->cell_cycle_increment = this->calc_cci(my_G1_length,my_Budded_phase);
-    this->theoretical_cci = cell_cycle_increment;
-    this->CP = 0;
+    my_store->phase[slot] = G1_PHASE;
+    this->set_cell_cycle_rates();
+    my_store->CP[slot] = 0;
     this->is_mother = true;
     this->has_bud = false;
+    this->curr_bud = -1;
     //curr_bud assigned in budding function
     //each new daughter is added to daughters vec in budding function
     this->curr_div_site = div_site;
     this->div_site_vec.push_back(curr_div_site);
-    this->is_bud = false;
-    //set in make founder function
+    my_store->is_bud[slot] = false;
+    //founders are their own mother
     this->mother_rank = rank;  
     //lineage vec filled out in make founder function
     griesemer_lineage.push_back(0);
     this->sector = rank;
     this->four_lineage = rank; 
     //**** get rid of these ASAP****
-    this->curr_protein = P_0;
+    my_store->protein[slot] = P_0;
     this->color = 0;
     //*************************
  
     return;
 }
 //Constructor for new daugher after division
-Cell::Cell(shared_ptr<Colony> my_colony, int rank, Coord cell_center, double init_radius, shared_ptr<Cell> mother,int mother_rank, double div_site, vector<int> lineage, vector<int>g_lineage,int sector, int my_col, double g_two_from_mother,int mother_four_lineage){
+Cell::Cell(Colony* my_colony, int rank, int slot, Coord cell_center, double init_radius, int mother_rank, double div_site, vector<int> lineage, vector<int>g_lineage,int sector, int my_col, double g_two_from_mother,int mother_four_lineage){
     this->my_colony = my_colony;
+    this->my_store = &my_colony->get_store();
     this->rank = rank;
-    this->cell_center = cell_center;
-    this->curr_radius = init_radius;
-    this->max_radius = average_radius + average_radius*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0);
-    this->at_max_size = false;
+    //the store entry was reserved by the colony before budding
+    this->slot = slot;
+    this->random_events = 0;
+    Random_Stream draws = this->next_random_stream();
+    my_store->x[slot] = cell_center.get_X();
+    my_store->y[slot] = cell_center.get_Y();
+    my_store->radius[slot] = init_radius;
+    my_store->max_radius[slot] = average_radius + average_radius*(draws.uniform(-10.0,10.0)/100.0);
+    my_store->at_max_size[slot] = false;
     //curr_force set in function
     //bin id assigned in function
     this->age = 0;
-    this->T_age = 0;
-    this->my_G1_length = g_two_from_mother + average_G1_daughter + average_G1_daughter*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0);
-    this->my_Budded_phase = average_budded_period_daughter + average_budded_period_daughter*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0); 
-    this->G1 = true;
-    this->G2 = false;
-    this->S = false;
-    this->M = false;
-    this->growth_rate = max_radius/(my_G1_length);
-    this->cell_cycle_increment = this->calc_cci(my_G1_length,my_Budded_phase);
-    this->theoretical_cci = cell_cycle_increment;
-    this->CP = 0;
+    my_store->T_age[slot] = 0;
+    this->my_G1_length = g_two_from_mother + average_G1_daughter + average_G1_daughter*(draws.uniform(-10.0,10.0)/100.0);
+    this->my_Budded_phase = average_budded_period_daughter + average_budded_period_daughter*(draws.uniform(-10.0,10.0)/100.0); 
+    my_store->phase[slot] = G1_PHASE;
+    this->set_cell_cycle_rates();
+    my_store->CP[slot] = 0;
     this->is_mother = false;
     this->has_bud = false;
+    this->curr_bud = -1;
     //curr_bud assigned in function
     //daughters vector updated in function
     this->curr_div_site = div_site;
     this->div_site_vec.push_back(curr_div_site);
-    this->is_bud = true;
-    this->mother = mother;
+    my_store->is_bud[slot] = true;
     this->mother_rank = mother_rank;
     this->lineage = lineage;
     this->griesemer_lineage = g_lineage;
@@ -104,13 +106,63 @@ Cell::Cell(shared_ptr<Colony> my_colony, int rank, Coord cell_center, double ini
     this->four_lineage = mother_four_lineage;  
     //******get rid of these ASAP**********
     this->equi_point = cell_center;
-    this->curr_protein = 0;
-    this->at_max_size = false;
+    my_store->protein[slot] = 0;
     this->color = my_col;
     //**************************************
 
     return;
 }
+//Constructor for a cell read back from a checkpoint,
+//fields in the order save writes them
+Cell::Cell(Colony* my_colony, Checkpoint_In& in){
+    this->my_colony = my_colony;
+    this->my_store = &my_colony->get_store();
+    this->rank = in.get_int();
+    this->slot = in.get_int();
+    this->random_events = in.get_uint();
+    this->age = in.get_int();
+    this->my_G1_length = in.get_double();
+    this->my_Budded_phase = in.get_double();
+    this->is_mother = in.get_int();
+    this->has_bud = in.get_int();
+    this->curr_bud = in.get_int();
+    in.get_vector(this->daughters);
+    in.get_vector(this->div_site_vec);
+    this->curr_div_site = in.get_double();
+    this->mother_rank = in.get_int();
+    in.get_vector(this->lineage);
+    in.get_vector(this->griesemer_lineage);
+    this->sector = in.get_int();
+    this->four_lineage = in.get_int();
+    this->color = in.get_int();
+    double equi_x = in.get_double();
+    double equi_y = in.get_double();
+    this->equi_point = Coord(equi_x,equi_y);
+    return;
+}
+void Cell::save(Checkpoint_Out& out){
+    out.put((int32_t)rank);
+    out.put((int32_t)slot);
+    out.put(random_events);
+    out.put((int32_t)age);
+    out.put(my_G1_length);
+    out.put(my_Budded_phase);
+    out.put((int32_t)is_mother);
+    out.put((int32_t)has_bud);
+    out.put((int32_t)curr_bud);
+    out.put_vector(daughters);
+    out.put_vector(div_site_vec);
+    out.put(curr_div_site);
+    out.put((int32_t)mother_rank);
+    out.put_vector(lineage);
+    out.put_vector(griesemer_lineage);
+    out.put((int32_t)sector);
+    out.put((int32_t)four_lineage);
+    out.put((int32_t)color);
+    out.put(equi_point.get_X());
+    out.put(equi_point.get_Y());
+    return;
+}
 //constructor for starting with multiple cells
 /*Cell::Cell(shared_ptr<Colony> my_colony, int rank, Coord cell_center, double max_radius, double init_radius, double div_site, int bud_status,int phase, double cell_prog,int Mother, int my_color){
     //cout << "im in" << endl;
@@ -220,23 +272,16 @@ void Cell::return_bud_status(){
 //*************************************************************************************************
 
 //***getters&setters that need a function,in order of cell.h***
-void Cell::set_mother(shared_ptr<Cell> mother){
-     this->mother = mother;
-     return;
-}
-void Cell::get_daughters_vec(vector<shared_ptr<Cell>>& curr_daughters){
-     shared_ptr<Cell> this_cell = shared_from_this();
-     curr_daughters = this_cell->daughters;
+void Cell::get_daughters_vec(vector<int>& curr_daughters){
+     curr_daughters = this->daughters;
      return;
 }
 void Cell::get_div_site_vec(vector<double>& previous_div_sites){
-     shared_ptr<Cell> this_cell = shared_from_this();
-     previous_div_sites = this_cell->div_site_vec;
+     previous_div_sites = this->div_site_vec;
      return;
 }
 void Cell::get_lineage_vec(vector<int>& curr_lineage_vec){
-     shared_ptr<Cell> this_cell = shared_from_this();
-     curr_lineage_vec = this_cell->lineage;
+     curr_lineage_vec = this->lineage;
      return;
 }
 void Cell::update_lineage_vec(int cell_rank){
@@ -244,133 +289,54 @@ void Cell::update_lineage_vec(int cell_rank){
      return;
 }
 void Cell::get_griesemer_lineage_vec(vector<int>& curr_griesemer_lineage){
-     shared_ptr<Cell> this_cell = shared_from_this();
-     curr_griesemer_lineage = this_cell->griesemer_lineage;
+     curr_griesemer_lineage = this->griesemer_lineage;
      return;
 }
-int Cell::get_phase(){
-	if(this->G1){
-		return 1;
-	}else if(this->G2){
-		return 2;
-	}else if(this->S){
-		return 3;
-	}else if(this->M){
-		return 4;
-	}
-}
 //****functions in order of cell.h***
-void Cell::find_bin(){
-     shared_ptr<Cell> this_cell = shared_from_this();	
-     vector<shared_ptr<Mesh_Pt>> mesh_pts;
-     this->get_colony()->get_mesh()->get_mesh_pts_vec(mesh_pts);
-     double smallest_dist=1000000;
-     int smallest_index;
-     double curr_dist;
-     //cout << "smallest index before starting" << smallest_index << endl;
-     for(unsigned int i = 0; i< mesh_pts.size();i++){
-     	curr_dist = (this->cell_center - mesh_pts.at(i)->get_center()).length();
-	if(curr_dist < smallest_dist){
-		smallest_dist = curr_dist;
-		smallest_index = mesh_pts.at(i)->get_index();
-		//cout << "smallest index " << smallest_index << endl;
-	}
-     }
-     //push cell back onto cell vector for that index
-     //cout << "smallest index " << smallest_index << endl;
-     this->my_colony->get_mesh()->assign_cell_to_bin(smallest_index,this_cell);
-     this->bin_id = smallest_index;
-     return;
+Random_Stream Cell::next_random_stream(){
+     //streams are keyed by rank, the counter keeps events apart
+     return Random_Stream(my_colony->get_seed(),rank,random_events++);
 }
 double Cell::calc_cci(double G1, double budding){
      double cci = 1.0/(G1 + budding);
      return cci;
 }
-void Cell::update_growth_rate(){
-     double multiplier = this->get_nutrient_conc(bin_id);
-     //this->my_G1_length = this->my_G1_length + this->my_G1_length*(1-multiplier);
-     //this->my_Budded_phase = this->my_Budded_phase + this->my_Budded_phase*(1-multiplier);
-     //this->cell_cycle_increment = calc_cci(this->my_G1_length,this->my_Budded_phase);
-     this->cell_cycle_increment = this->theoretical_cci*multiplier;
-     //cout << "Nutrient Conc: " << multiplier << "Cell cycle: " << cell_cycle_increment << endl; 
-     return;
-}
-double Cell::get_nutrient_conc(int curr_bin_id){
-     shared_ptr<Colony> my_colony= this->get_colony();
-     shared_ptr<Mesh> my_mesh = my_colony->get_mesh();
-     double nutrient_conc = my_mesh->get_nutrient_conc(curr_bin_id);
-     return nutrient_conc;
-}
-void Cell::grow_cell(){
-    if(!at_max_size){
-     	//cout << "Rank " << rank << " size " << curr_radius << "set max size " << max_radius << endl;
-	curr_radius = curr_radius + growth_rate*dt;
-	//cout << "Rank: " << rank << "Curr radius: " << curr_radius << endl;
-    }
-    if(curr_radius >= max_radius){
-	//cout << "made it" << endl;
-	this->at_max_size = true;
-    }
+void Cell::set_cell_cycle_rates(){
+    //derived from max radius and the G1/budded lengths,
+    //the store kernels only read these
+    my_store->growth_rate[slot] = my_store->max_radius[slot]/(my_G1_length);
+    my_store->cell_cycle_increment[slot] = this->calc_cci(my_G1_length,my_Budded_phase);
+    my_store->theoretical_cci[slot] = my_store->cell_cycle_increment[slot];
+    my_store->G1_threshold[slot] = this->my_G1_length/(my_G1_length + my_Budded_phase);
     return;
 }
-void Cell::daughter_to_mother_cell_cycle_changes(){
-    this->my_G1_length = average_G1_mother + average_G1_mother*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0); 
-    this->my_Budded_phase = average_budded_period_mother + average_budded_period_mother*(this->my_colony->uniform_random_real_number(-10.0,10.0)/100.0);
-    this->growth_rate = max_radius/(my_G1_length);
-    this->cell_cycle_increment = this->calc_cci(my_G1_length,my_Budded_phase);
-    this->theoretical_cci = cell_cycle_increment;
+void Cell::daughter_to_mother_cell_cycle_changes(Random_Stream& draws){
+    this->my_G1_length = average_G1_mother + average_G1_mother*(draws.uniform(-10.0,10.0)/100.0); 
+    this->my_Budded_phase = average_budded_period_mother + average_budded_period_mother*(draws.uniform(-10.0,10.0)/100.0);
+    this->set_cell_cycle_rates();
     return;
 }
-double Cell::G1_check(){
-     return this->my_G1_length/(my_G1_length + my_Budded_phase);
-}
-
-void Cell::update_cell_cycle(){
-     this->T_age++;
-     shared_ptr<Cell> this_cell = shared_from_this();
-     if((this->G1) && (this->CP >= G1_check())){
-	this->G1 = false;
-	this->S = true;
-	//cout << "Rank: " << rank << "CP: " << CP << endl;
-     }
-     if((this->G2) && (this->CP >= 1)){
-	this->G2 = false;
-	this->M = true;
-     }
-     //cout << "cell cycle" << cell_cycle_increment << "actual " << CP << endl;
-     CP = CP + cell_cycle_increment*dt;	
-     //cout << "cell cycle" << cell_cycle_increment << "actual " << CP << endl;
-	
-     return;
-}
-void Cell::enter_mitosis(){
-     G1 = false;
-     S = false;
-     G2 = false;
-     M = true;
-     return;
-}
-void Cell::perform_budding(int Ti){
+template<int DIVISION>
+unique_ptr<Cell> Cell::perform_budding(int Ti, int daughter_cell_rank, int daughter_slot){
+    Random_Stream draws = this->next_random_stream();
     //cout << "Rank: " << this->get_rank() << "Bud Formed: " << Ti << "Curr Radius: " << this->curr_radius << endl;
     //increment budding age
     this-> age = age+1;
-    shared_ptr<Cell> this_cell = shared_from_this();
-    shared_ptr<Colony> this_colony = this->get_colony();
-    int daughter_cell_rank = this_colony->get_num_cells();
+    Colony* this_colony = this->get_colony();
     double daughter_init_radius = 0;
     double mother_division_site;
     bool used = false;
     
      if(mother_status()){
-    	if(Division_Pattern==0){//axial
+    	if(DIVISION == 0){//axial
     		mother_division_site = this->curr_div_site;//axial same side
-    	}else if(Division_Pattern == 1){//bipolar
+    	}else if(DIVISION == 1){//bipolar
 		mother_division_site = this->curr_div_site + M_PI;//bipolar opposite side
 		if(mother_division_site > 2*M_PI){
 			mother_division_site = mother_division_site - 2*M_PI;
 		}
-	}else if(Division_Pattern == 2){//random
-		if(this->get_colony()->uniform_random_real_number(0.0,1.0)<=.5){
+	}else if(DIVISION == 2){//random
+		if(draws.uniform(0.0,1.0)<=.5){
 			mother_division_site = this->curr_div_site + M_PI;
 			if(mother_division_site > 2*M_PI){
 				mother_division_site = mother_division_site - 2*M_PI;
@@ -386,7 +352,7 @@ void Cell::perform_budding(int Ti){
      }	
     
     //50% chance move up or down a little
-    if(this->get_colony()->uniform_random_real_number(0.0,1.0)<=.5){
+    if(draws.uniform(0.0,1.0)<=.5){
     	//move 10 degrees counter clockwise until new spot found
     	do{	
 		used = false;
@@ -413,8 +379,9 @@ void Cell::perform_budding(int Ti){
     this->div_site_vec.push_back(mother_division_site);
     this->curr_div_site = mother_division_site;
     //cout << "rank " << this-> rank << " divsite " << division_site << endl;
-    double new_center_x = this->cell_center.get_X()+(curr_radius+daughter_init_radius)*cos(curr_div_site);
-    double new_center_y = this->cell_center.get_Y()+(curr_radius+daughter_init_radius)*sin(curr_div_site);
+    double curr_radius = my_store->radius[slot];
+    double new_center_x = my_store->x[slot]+(curr_radius+daughter_init_radius)*cos(curr_div_site);
+    double new_center_y = my_store->y[slot]+(curr_radius+daughter_init_radius)*sin(curr_div_site);
     Coord new_center = Coord(new_center_x,new_center_y);
     vector<int> new_lineage;
     this->get_lineage_vec(new_lineage);
@@ -434,42 +401,42 @@ void Cell::perform_budding(int Ti){
     int mother_four_lineage = this->four_lineage;
     //cout << "New cell rank: " << new_rank << endl;
     //****new cell stuff***
-    auto new_cell = make_shared<Cell>(this_colony, daughter_cell_rank, new_center, daughter_init_radius,this_cell,this->rank,mother_division_site+M_PI,new_lineage, new_g_lineage, sector,this->color,this->my_Budded_phase,mother_four_lineage);
-    new_cell->find_bin();
+    unique_ptr<Cell> new_cell(new Cell(this_colony, daughter_cell_rank, daughter_slot, new_center, daughter_init_radius,this->rank,mother_division_site+M_PI,new_lineage, new_g_lineage, sector,this->color,this->my_Budded_phase,mother_four_lineage));
     //***mother cell stuff***
-    this->G1 = false;
-    this->S = false;
-    this->G2 = true;
-    this->M = false;
+    my_store->phase[slot] = G2_PHASE;
     this->is_mother = true;
     this->has_bud = true;
-    this->curr_bud = new_cell;
-    this->daughters.push_back(new_cell);
+    this->curr_bud = daughter_cell_rank;
+    this->daughters.push_back(daughter_cell_rank);
     this->div_site_vec.push_back(mother_division_site);
     //**colony stuff***
-    this_colony->update_colony_cell_vec(new_cell);
+    //the colony adds the bud and its bond in rank order
     this->equi_point = Coord(curr_radius*cos(mother_division_site + M_PI/2),curr_radius*sin(mother_division_site + M_PI/2));
-    return;
+    return new_cell;
 }
+//axial, bipolar and random versions
+template unique_ptr<Cell> Cell::perform_budding<0>(int Ti, int daughter_cell_rank, int daughter_slot);
+template unique_ptr<Cell> Cell::perform_budding<1>(int Ti, int daughter_cell_rank, int daughter_slot);
+template unique_ptr<Cell> Cell::perform_budding<2>(int Ti, int daughter_cell_rank, int daughter_slot);
 void Cell::perform_mitosis(int Ti){
     //separate mother and daughter
     //cout << "reset is bud" << endl;
     //cout << "mitosis time " << Ti << " " << this->get_rank() << endl;
     //cout << this->curr_bud << endl;
-    double bud_prot = this->curr_protein*.4;
-    double mother_prot = this->curr_protein*.6;
+    double curr_protein = my_colony->get_protein(slot);
+    double bud_prot = curr_protein*.4;
+    double mother_prot = curr_protein*.6;
     //cout << "Mother before: " << mother_prot << " " << bud_prot << endl;
-    this->set_protein_conc(this->curr_protein*.6);
-    this->curr_bud->set_protein_conc(bud_prot);
+    Cell& bud = this->my_colony->get_cell(curr_bud);
+    this->set_protein_conc(mother_prot);
+    bud.set_protein_conc(bud_prot);
     this->set_has_bud_to_false();
-    this->curr_bud->set_is_bud_to_false(); 
-    this->G1 = true;
-    this->S = false;
-    this->G2 = false;
-    this->M = false;
-    this->CP = 0;
+    bud.set_is_bud_to_false(); 
+    my_store->phase[slot] = G1_PHASE;
+    my_store->CP[slot] = 0;
     if(this->age == 1){
-	this->daughter_to_mother_cell_cycle_changes();
+	Random_Stream draws = this->next_random_stream();
+	this->daughter_to_mother_cell_cycle_changes(draws);
     }
     //daughter remains G1 and mother gets set to G1
     return;
@@ -479,143 +446,30 @@ void Cell::set_has_bud_to_false(){
     return;
 }
 void Cell::set_is_bud_to_false(){
-    this->is_bud = false;
-    return;
-}
-void Cell::compute_protein_concentration(){
-    if(!is_bud){
-	this->curr_protein = curr_protein + r_LOGISTIC*curr_protein*(1-curr_protein/K_LOGISTIC)*(curr_protein/A_LOGISTIC -1)*dt;
-    //this->curr_protein = curr_protein + r_LOGISTIC*curr_protein*(1-curr_protein/K_LOGISTIC);
-    }
+    my_store->is_bud[slot] = false;
     return;
 }
 void Cell::set_protein_conc(double protein){
-	this->curr_protein = protein;
+	my_store->protein[slot] = protein;
+	my_store->protein_time[slot] = my_colony->get_time();
 	return;
 }
-void Cell::get_cell_force(){
-    Coord force;
-    vector<shared_ptr<Cell>> neighbor_cells;
-    this->my_colony->get_mesh()->get_cells_from_bin(this->bin_id,neighbor_cells);
-    shared_ptr<Cell> this_cell = shared_from_this();
-    #pragma omp parallel
-    {
-    	#pragma omp declare reduction(+:Coord:omp_out+=omp_in) initializer(omp_priv(omp_orig))
-	#pragma omp for reduction(+:force) schedule(static,1)
-	for(unsigned int i = 0; i< neighbor_cells.size();i++){
-    		if(neighbor_cells.at(i) != this_cell){
-			//cout << "force on cell: " << i << endl;
-			force += this_cell->calc_forces_Hertz(neighbor_cells.at(i));
-		}
-	}
-     }
-     this->curr_force = force;
-     return;
-}
-Coord Cell::calc_forces_Hertz(shared_ptr<Cell> my_neighbor){
-    //Describe force calculation in README!!!
-    //vector<shared_ptr<Cell>> neighbor_cells;
-    Coord my_loc = cell_center;
-    double my_radius = curr_radius;
-    Coord neighbor_loc;
-    double neighbor_radius;
-    Coord rep_force = Coord(0,0);
-    Coord adh_force = Coord(0,0);
-    Coord adh_force_reg = Coord(0,0);
-    Coord bending_force = Coord(0,0);
-    //distance between two cell centers
-    double d_ij;
-    //vector for direction of force
-    Coord v_ij;
-    double E_ij_inverse = 1/((3.0/4.0)*(2*(1-pow(POISSON,2))/ELASTIC_MOD));
-    double sqrt_term;
-    //bending force necessities
-    //the angle made by my cell center, mom cell center and equilibrium point on mom membrane
-    double curr_angle;
-    //equilibrium angle is 90
-    double eps = 0.0001;
-    Coord mom_center = this->mother->get_cell_center();
-    //Coord equi_point = this->mother->get_equi_point();
-    shared_ptr<Cell> this_cell = shared_from_this();
-    //for(unsigned int i = 0; i< neighbor_cells.size();i++){
-    	if(my_neighbor != this_cell){
-		neighbor_loc = my_neighbor->get_cell_center();
-		neighbor_radius = my_neighbor->get_curr_radius();
-		d_ij = (my_loc-neighbor_loc).length();
-		v_ij = (my_loc - neighbor_loc);
-		sqrt_term = sqrt((my_radius*neighbor_radius)/(my_radius+neighbor_radius));
-		if(Budding_On == 1){
-			//cout << "ADH_VARIABLE == " << ADH_ON << endl;
-			//ADHESION_ON IS A BOOLEAN IN PARAMETERS FILE
-			//turns in adhesion between mother and bud
-			if((my_neighbor == curr_bud)){
-                		if(this->has_bud){
-                        		//cout << "Cell rank " << this->rank << " has daughter " << this->curr_bud->get_rank() << endl;
-					//if(my_radius+neighbor_radius - d_ij < 0){
-                        			adh_force += v_ij*-1*K_ADH*(d_ij-(my_radius+neighbor_radius));
-					//}
-                    		}
-                    	}
-			else if((my_neighbor == mother)){
-                       		if(this->is_bud){
-                        		//if(my_radius+neighbor_radius - d_ij < 0){
-                        			adh_force += v_ij*-1*K_ADH*(d_ij-(my_radius+neighbor_radius));
-						//curr_angle = this->compute_angle();
-						//if(abs(curr_angle - pi/2) < eps){
-							//do nothing theyre close
-						//}
-						/*else{
-							double bend_constant = K_BEND*(curr_angle-pi/2)/(sqrt(1-pow(cos(curr_angle),2)));
-							Coord me_to_mom = mom_center- cell_center;
-							double me_to_mom_length = me_to_mom.length();
-							Coord mom_to_equi_point = equi_point-mom_center;
-							double mom_to_equi_point_length = mom_to_equi_point.length();
-							Coord term1 = mom_to_equi_point/(mom_to_equi_point_length*me_to_mom_length);
-							Coord term2 = me_to_mom*cos(curr_angle)/pow(me_to_mom_length,2);
-							bending_force = (term1 + term2)*bend_constant;
-						}*/
-					//}
-				}
-			}
-		}	
-		if(my_radius + neighbor_radius - d_ij >= 0){
-			rep_force += v_ij*.5*(1/d_ij)*pow(my_radius+neighbor_radius -d_ij,1.5)*E_ij_inverse*sqrt_term;
-			//cout << "rep_force" << rep_force << endl;
-		}
-		if((my_radius + neighbor_radius - d_ij < 1) && (my_radius + neighbor_radius - d_ij > -1)){
-			adh_force_reg += v_ij*SINGLE_BOND_BIND_ENERGY*RECEPTOR_SURF_DENSITY*KB*TEMPERATURE*M_PI*(my_radius + neighbor_radius)*.5*-1;
-		}		
-		
-		
-	
-     }
-     //cout << "Rep_force" << rep_force << endl;
-     //Coord unit_vec = (rep_force + adh_force + adh_force_reg);
-     //double length_vec =  (rep_force + adh_force + adh_force_reg).length();
-     //cout  <<"unit vec" << unit_vec<< "length" << length_vec <<  endl;
-     curr_force = rep_force + adh_force + adh_force_reg;
-     //cout <<"curr force"  << curr_force << endl;// + adh_force;// + bending_force;
-     return curr_force;
-}
-void Cell::update_location(){
-    cell_center = cell_center + curr_force*(1.0/(1.0+eta*(curr_radius)))*dt;
-    return;
-}
-void Cell::print_txt_file_format(ofstream& ofs){
-    ofs << rank << " " << cell_center.get_X() << " " << cell_center.get_Y() << " " << curr_radius << " ";
-    for(unsigned int i = 0; i < this->griesemer_lineage.size();i++){
-    	ofs << "/" << griesemer_lineage.at(i);
-    }
-    ofs << " ";
-    //cout << "getting vec" << endl;
-    vector<int> lineages;
-    get_lineage_vec(lineages);
-    //cout << "lineages loop" << endl;
-    for(unsigned int i = 0; i < lineages.size();i++){
-    ofs << "/" << lineages.at(i);
-    }
-    ofs << " " << this->get_sector() << " " << this->get_age() << " " << this->get_T_age() << " " << this->bud_status() << " " << this->get_phase() << " " << this->get_CP() << " " << this->mother->get_rank() << " " << this->curr_protein << " " << bin_id << " " << four_lineage << endl;
-    //ofs << " " << this->get_color() << endl;
+void Cell::copy_to_snapshot(Snapshot& frame, int row){
+    frame.rank[row] = rank;
+    frame.x[row] = my_store->x[slot];
+    frame.y[row] = my_store->y[slot];
+    frame.radius[row] = my_store->radius[slot];
+    frame.sector[row] = this->get_sector();
+    frame.age[row] = this->get_age();
+    frame.T_age[row] = this->get_T_age();
+    frame.is_bud[row] = this->bud_status();
+    frame.phase[row] = this->get_phase();
+    frame.CP[row] = this->get_CP();
+    frame.mother_rank[row] = this->mother_rank;
+    frame.protein[row] = this->get_curr_protein();
+    frame.bin_id[row] = this->get_bin_id();
+    frame.four_lineage[row] = four_lineage;
+    //frame.color[row] = this->get_color();
     return;
 }
 //*******OLD******************
@@ -762,8 +616,8 @@ void Cell::calc_forces_chou(){
     //this->my_colony->get_mesh()->get_cells_from_bin(this->bin_id,neighbor_cells);
 	
     my_colony->get_Cells(neighbor_cells);
-    Coord my_loc = cell_center;
-    double my_radius = curr_radius;
+    Coord my_loc = this->get_cell_center();
+    double my_radius = this->get_curr_radius();
     Coord neighbor_loc;
     double neighbor_radius;
     Coord rep_force;
@@ -884,8 +738,8 @@ void Cell::calc_forces_exponential(){
 void Cell::lennard_jones_potential(){
     vector<shared_ptr<Cell>> neighbor_cells;
     my_colony->get_Cells(neighbor_cells);
-    Coord my_loc = cell_center;
-    double my_radius = curr_radius;
+    Coord my_loc = this->get_cell_center();
+    double my_radius = this->get_curr_radius();
     Coord neighbor_loc;
     double neighbor_radius;
     Coord rep_force;
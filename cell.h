@@ -11,8 +11,6 @@ class Colony;
 
 //*********************************************************
 // include dependencies
-#include <boost/enable_shared_from_this.hpp>
-#include <boost/shared_ptr.hpp>
 #include <string>
 #include <vector>
 #include <fstream>
@@ -21,91 +19,95 @@ class Colony;
 #include <memory>
 #include "parameters.h"
 #include "coord.h"
+#include "cell_store.h"
+#include "philox.h"
+#include "snapshot.h"
+#include "checkpoint.h"
 #include "externs.h"
 //***********************************************************
 // Cell Class Declaration
 
-class Cell: public enable_shared_from_this<Cell>{
+class Cell {
 	private:
-		shared_ptr<Colony> my_colony;
+		//owned by the colony
+		Colony* my_colony;
+		//per step state lives in the colony's store at index slot,
+		//rank is the cell's identity and never changes
+		Cell_Store* my_store;
 		int rank;
-		Coord cell_center;
-		double curr_radius;
-		double max_radius;
-		bool at_max_size;
-		Coord curr_force;
-		int bin_id;
+		int slot;
+		//random events drawn so far, each gets its own stream
+		uint32_t random_events;
 		int age;
-		int T_age;
 		double my_G1_length;
 		double my_Budded_phase;
-		bool G1;
-		bool S;
-		bool G2;
-		bool M;
-		double growth_rate;
-		double cell_cycle_increment;
-		double theoretical_cci;
-		double CP;
 		bool is_mother;
 		bool has_bud;
-		shared_ptr<Cell> curr_bud;
-		vector<shared_ptr<Cell>> daughters;
+		//links to other cells are ranks, -1 for none
+		int curr_bud;
+		vector<int> daughters;
 		vector<double> div_site_vec;
 		double curr_div_site;
-		bool is_bud;
-		shared_ptr<Cell> mother;
 		int mother_rank;
 		vector<int> lineage;
 		vector<int> griesemer_lineage;
 		int sector;
 		int four_lineage;
-		double curr_protein;
         	int color;
 		Coord equi_point;
+		void set_cell_cycle_rates();
+		Random_Stream next_random_stream();
 	public:
 		//Constructor for single founder
-		Cell(shared_ptr<Colony> colony, int rank, Coord cell_center, double init_radius, double div_site);
+		Cell(Colony* colony, int rank, Coord cell_center, double init_radius, double div_site);
         	//Constructor for new daughter after division
-        	Cell(shared_ptr<Colony> colony, int rank, Coord cell_center, double init_radius, shared_ptr<Cell> mmother,int mother_rank,double div_site, vector<int> lineage, vector<int> g_lineage, int sector, int my_col,double g2_from_mother,int mother_four_lineage);	
+        	//the colony reserves the bud's store slot beforehand
+        	Cell(Colony* colony, int rank, int slot, Coord cell_center, double init_radius, int mother_rank,double div_site, vector<int> lineage, vector<int> g_lineage, int sector, int my_col,double g2_from_mother,int mother_four_lineage);	
+		//Constructor for a cell read back from a checkpoint, its
+		//store entry is restored by the colony
+		Cell(Colony* colony, Checkpoint_In& in);
+		void save(Checkpoint_Out& out);
 		/*Cell(shared_ptr<Colony> colony, int rank, Coord cell_center, double max_radius, double init_radius, double div_site, int bud_status, int phase, double CP, int Mother, int my_col);*/	
 		//***Getters***	
-		shared_ptr<Colony> get_colony(){return my_colony;}
+		Colony* get_colony(){return my_colony;}
 		int get_rank(){return rank;}
-		Coord get_cell_center(){return cell_center;}
- 		double get_curr_radius(){return curr_radius;}
-                double get_max_radius(){return max_radius;}
-		Coord get_curr_force(){return curr_force;}
-		int get_bin_id(){return bin_id;}
+		int get_slot(){return slot;}
+		//the colony moves a cell's store entry when it reorders
+		void set_slot(int slot){this->slot = slot;}
+		Coord get_cell_center(){return Coord(my_store->x[slot],my_store->y[slot]);}
+ 		double get_curr_radius(){return my_store->radius[slot];}
+                double get_max_radius(){return my_store->max_radius[slot];}
+		Coord get_curr_force(){return Coord(my_store->force_x[slot],my_store->force_y[slot]);}
+		int get_bin_id(){return my_store->bin_id[slot];}
 		int get_age(){return age;}
-		int get_T_age(){return T_age;}
+		int get_T_age(){return my_store->T_age[slot];}
 		double get_G1_length(){return my_G1_length;}
 		double get_G2_length(){return my_Budded_phase;}
-		bool is_G1(){return G1;}
-		bool is_G2(){return G2;}
-		bool is_S(){return S;}
-		bool is_M(){return M;}
-		double get_growth_rate(){return growth_rate;}
-		double get_cell_cycle_increment(){return cell_cycle_increment;}
-		double get_CP(){return CP;}
+		bool is_G1(){return my_store->phase[slot] == G1_PHASE;}
+		bool is_G2(){return my_store->phase[slot] == G2_PHASE;}
+		bool is_S(){return my_store->phase[slot] == S_PHASE;}
+		bool is_M(){return my_store->phase[slot] == M_PHASE;}
+		double get_growth_rate(){return my_store->growth_rate[slot];}
+		double get_cell_cycle_increment(){return my_store->cell_cycle_increment[slot];}
+		double get_CP(){return my_store->CP[slot];}
 		bool mother_status(){return is_mother;}
 		bool currently_has_bud(){return has_bud;}
-		shared_ptr<Cell> get_curr_bud(){return curr_bud;}
-		void get_daughters_vec(vector<shared_ptr<Cell>>& curr_daughters);
+		int get_curr_bud(){return curr_bud;}
+		void get_daughters_vec(vector<int>& curr_daughters);
 		void get_div_site_vec(vector<double>& previous_div_sites);
 		double get_curr_div_site(){return curr_div_site;}
-		bool bud_status(){return is_bud;}
-		shared_ptr<Cell>get_mother(){return mother;}
-		void set_mother(shared_ptr<Cell> mother);
+		bool bud_status(){return my_store->is_bud[slot];}
 		int get_mother_rank(){return mother_rank;}
 		void get_lineage_vec(vector<int>& curr_lineage_vec);
+		const vector<int>& get_lineage(){return lineage;}
 		void update_lineage_vec(int mother_rank);
 		void get_griesemer_lineage_vec(vector<int>& curr_griesemer_lineage);
+		const vector<int>& get_griesemer_lineage(){return griesemer_lineage;}
 		int get_sector(){return sector;}
-		bool grown_to_full_size(){return at_max_size;}
-		double get_curr_protein(){return curr_protein;}
+		bool grown_to_full_size(){return my_store->at_max_size[slot];}
+		double get_curr_protein(){return my_store->protein[slot];}
 		int get_color(){return color;}
-		int get_phase();	
+		int get_phase(){return my_store->phase[slot];}
 		//***functions used when starting with > 1 cell***
 		void mother_bud_check();
 		void get_bud_status_mom(shared_ptr<Cell> mother);
@@ -114,28 +116,21 @@ class Cell: public enable_shared_from_this<Cell>{
 		void return_bud_status();
 		//***************************************************
 
-		//functions used to put cell in correct bin
-		void find_bin();
-		//functions used to adjust growth rate of cells based
-		//on nutrient concentration of their current bin
 		double calc_cci(double G1, double budding);
-		void update_growth_rate();	 		
-   		double get_nutrient_conc(int bin_id);
-		void grow_cell();
-		void daughter_to_mother_cell_cycle_changes();
-		double G1_check();
-		void update_cell_cycle();
-		void enter_mitosis();
-		void perform_budding(int Ti);
+		void daughter_to_mother_cell_cycle_changes(Random_Stream& draws);
+		//DIVISION is the division pattern, see Division_Pattern.
+		//Budding and mitosis only touch this cell, its bud and the
+		//new cell, so the colony runs them in parallel
+		//the daughter fills store entry daughter_slot, reserved by
+		//the colony
+		template<int DIVISION> unique_ptr<Cell> perform_budding(int Ti, int daughter_rank, int daughter_slot);
 		void perform_mitosis(int Ti);
 		void set_has_bud_to_false();
 		void set_is_bud_to_false();
-		void compute_protein_concentration();
 		void set_protein_conc(double protein);
-		void get_cell_force();
- 		Coord calc_forces_Hertz(shared_ptr<Cell> my_neighbor);
-		void update_location();
-		void print_txt_file_format(ofstream& ofs); 
+		//fills this cell's row of an output frame, lineages
+		//are copied by the colony
+		void copy_to_snapshot(Snapshot& frame, int row);
 		/*void mother_rank_to_ptr();
 		int get_phase();
 		void get_bud_status_mom(shared_ptr<Cell> mother);
@@ -0,0 +1,131 @@
+//cell_store.cpp
+
+//******************************************
+//Include Dependencies
+#include <vector>
+#include "parameters.h"
+#include "coord.h"
+#include "cell_store.h"
+#include "checkpoint.h"
+using namespace std;
+//****************************************
+//Public Member Functions for cell_store.cpp
+
+template<typename T>
+static void permute_field(vector<T>& field, const vector<int>& order){
+	vector<T> moved(order.size());
+	for(unsigned int i = 0; i < order.size(); i++){
+		moved[i] = field[order[i]];
+	}
+	field.swap(moved);
+	return;
+}
+
+//constructor
+Cell_Store::Cell_Store(){
+	return;
+}
+int Cell_Store::add_cell(){
+	x.push_back(0);
+	y.push_back(0);
+	radius.push_back(0);
+	max_radius.push_back(0);
+	force_x.push_back(0);
+	force_y.push_back(0);
+	CP.push_back(0);
+	G1_threshold.push_back(0);
+	growth_rate.push_back(0);
+	cell_cycle_increment.push_back(0);
+	theoretical_cci.push_back(0);
+	protein.push_back(0);
+	protein_time.push_back(0);
+	phase.push_back(G1_PHASE);
+	at_max_size.push_back(false);
+	is_bud.push_back(false);
+	T_age.push_back(0);
+	bin_id.push_back(0);
+	bin_key.push_back(NO_BIN_KEY);
+	asleep.push_back(false);
+	quiet_steps.push_back(0);
+	return x.size()-1;
+}
+void Cell_Store::permute(const vector<int>& order){
+	permute_field(x,order);
+	permute_field(y,order);
+	permute_field(radius,order);
+	permute_field(max_radius,order);
+	permute_field(force_x,order);
+	permute_field(force_y,order);
+	permute_field(CP,order);
+	permute_field(G1_threshold,order);
+	permute_field(growth_rate,order);
+	permute_field(cell_cycle_increment,order);
+	permute_field(theoretical_cci,order);
+	permute_field(protein,order);
+	permute_field(protein_time,order);
+	permute_field(phase,order);
+	permute_field(at_max_size,order);
+	permute_field(is_bud,order);
+	permute_field(T_age,order);
+	permute_field(bin_id,order);
+	permute_field(bin_key,order);
+	permute_field(asleep,order);
+	permute_field(quiet_steps,order);
+	return;
+}
+void Cell_Store::save(Checkpoint_Out& out) const{
+	out.put_vector(x);
+	out.put_vector(y);
+	out.put_vector(radius);
+	out.put_vector(max_radius);
+	out.put_vector(force_x);
+	out.put_vector(force_y);
+	out.put_vector(CP);
+	out.put_vector(G1_threshold);
+	out.put_vector(growth_rate);
+	out.put_vector(cell_cycle_increment);
+	out.put_vector(theoretical_cci);
+	out.put_vector(protein);
+	out.put_vector(protein_time);
+	out.put_vector(phase);
+	out.put_vector(at_max_size);
+	out.put_vector(is_bud);
+	out.put_vector(T_age);
+	out.put_vector(bin_id);
+	out.put_vector(bin_key);
+	out.put_vector(asleep);
+	out.put_vector(quiet_steps);
+	return;
+}
+void Cell_Store::load(Checkpoint_In& in){
+	in.get_vector(x);
+	in.get_vector(y);
+	in.get_vector(radius);
+	in.get_vector(max_radius);
+	in.get_vector(force_x);
+	in.get_vector(force_y);
+	in.get_vector(CP);
+	in.get_vector(G1_threshold);
+	in.get_vector(growth_rate);
+	in.get_vector(cell_cycle_increment);
+	in.get_vector(theoretical_cci);
+	in.get_vector(protein);
+	in.get_vector(protein_time);
+	in.get_vector(phase);
+	in.get_vector(at_max_size);
+	in.get_vector(is_bud);
+	in.get_vector(T_age);
+	in.get_vector(bin_id);
+	in.get_vector(bin_key);
+	in.get_vector(asleep);
+	in.get_vector(quiet_steps);
+	//every field is indexed by slot, so all must have a value per cell
+	size_t num_cells = x.size();
+	size_t sizes[] = {y.size(),radius.size(),max_radius.size(),force_x.size(),force_y.size(),CP.size(),G1_threshold.size(),growth_rate.size(),cell_cycle_increment.size(),theoretical_cci.size(),protein.size(),protein_time.size(),phase.size(),at_max_size.size(),is_bud.size(),T_age.size(),bin_id.size(),bin_key.size(),asleep.size(),quiet_steps.size()};
+	for(size_t size : sizes){
+		if(size != num_cells){
+			in.fail();
+		}
+	}
+	return;
+}
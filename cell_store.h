@@ -0,0 +1,74 @@
+// cell_store.h
+
+//*********************************************************
+// Include Guards
+#ifndef _CELL_STORE_H_INCLUDED_
+#define _CELL_STORE_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+
+//*********************************************************
+// include dependencies
+#include <vector>
+#include <stdint.h>
+#include "parameters.h"
+#include "coord.h"
+#include "checkpoint.h"
+//*********************************************************
+//cell cycle phases, values match the phase column of the output
+enum Cell_Phase {G1_PHASE = 1, G2_PHASE = 2, S_PHASE = 3, M_PHASE = 4};
+//bin key of a cell that has not been binned yet, no real bin has it
+const int64_t NO_BIN_KEY = INT64_MIN;
+
+//*********************************************************
+// Cell_Store Class Declaration
+
+//Per cell state that is read or written every timestep.
+//Each field is one contiguous array indexed by cell slot so the
+//colony wide kernels stream through memory, lineage and other
+//rarely used data stays in the Cell objects.
+class Cell_Store {
+	public:
+		vector<double> x;
+		vector<double> y;
+		vector<double> radius;
+		vector<double> max_radius;
+		vector<double> force_x;
+		vector<double> force_y;
+		vector<double> CP;
+		//CP at which G1 ends
+		vector<double> G1_threshold;
+		vector<double> growth_rate;
+		vector<double> cell_cycle_increment;
+		vector<double> theoretical_cci;
+		//protein was last brought up to date at protein_time
+		vector<double> protein;
+		vector<double> protein_time;
+		vector<char> phase;
+		vector<char> at_max_size;
+		vector<char> is_bud;
+		vector<int> T_age;
+		vector<int> bin_id;
+		//mesh key of bin_id, NO_BIN_KEY until first binned
+		vector<int64_t> bin_key;
+		//sleeping cells are left out of mechanics, quiet_steps
+		//counts the steps an awake cell has been still
+		vector<char> asleep;
+		vector<int> quiet_steps;
+	public:
+		//constructor
+		Cell_Store();
+		//appends a zeroed cell and returns its index
+		int add_cell();
+		//moves the cell at slot order[i] to slot i in every field
+		void permute(const vector<int>& order);
+		void save(Checkpoint_Out& out) const;
+		void load(Checkpoint_In& in);
+		int size() const {return x.size();}
+};
+
+//End Cell_Store Class
+//**************************************************************
+#endif
+
@@ -0,0 +1,125 @@
+//checkpoint.cpp
+
+//******************************************
+//Include Dependencies
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "checkpoint.h"
+using namespace std;
+//****************************************
+//Public Member Functions for Checkpoint_Out
+
+//constructor
+Checkpoint_Out::Checkpoint_Out(const string& filename){
+	this->filename = filename;
+	ofs.open((filename + ".tmp").c_str(),ios::binary);
+	ofs.write(CHECKPOINT_MAGIC,sizeof(CHECKPOINT_MAGIC));
+	put(CHECKPOINT_VERSION);
+	put((uint32_t)0x01020304);
+	return;
+}
+void Checkpoint_Out::put(int32_t value){
+	ofs.write((const char*)&value,sizeof(value));
+	return;
+}
+void Checkpoint_Out::put(uint32_t value){
+	ofs.write((const char*)&value,sizeof(value));
+	return;
+}
+void Checkpoint_Out::put(int64_t value){
+	ofs.write((const char*)&value,sizeof(value));
+	return;
+}
+void Checkpoint_Out::put(uint64_t value){
+	ofs.write((const char*)&value,sizeof(value));
+	return;
+}
+void Checkpoint_Out::put(double value){
+	ofs.write((const char*)&value,sizeof(value));
+	return;
+}
+template<typename T>
+void Checkpoint_Out::put_vector(const vector<T>& values){
+	put((uint64_t)values.size());
+	ofs.write((const char*)values.data(),values.size()*sizeof(T));
+	return;
+}
+template void Checkpoint_Out::put_vector(const vector<int>& values);
+template void Checkpoint_Out::put_vector(const vector<double>& values);
+template void Checkpoint_Out::put_vector(const vector<char>& values);
+template void Checkpoint_Out::put_vector(const vector<int64_t>& values);
+bool Checkpoint_Out::close(){
+	ofs.close();
+	if(!ofs){
+		remove((filename + ".tmp").c_str());
+		return false;
+	}
+	return rename((filename + ".tmp").c_str(),filename.c_str()) == 0;
+}
+//****************************************
+//Public Member Functions for Checkpoint_In
+
+//constructor
+Checkpoint_In::Checkpoint_In(const string& filename){
+	ifs.open(filename.c_str(),ios::binary);
+	ifs.seekg(0,ios::end);
+	this->length = ifs.good() ? (uint64_t)ifs.tellg() : 0;
+	ifs.seekg(0,ios::beg);
+	char magic[sizeof(CHECKPOINT_MAGIC)];
+	ifs.read(magic,sizeof(magic));
+	uint32_t version = get_uint();
+	uint32_t byte_order = get_uint();
+	if(memcmp(magic,CHECKPOINT_MAGIC,sizeof(magic)) || (version != CHECKPOINT_VERSION) || (byte_order != 0x01020304)){
+		ifs.setstate(ios::failbit);
+	}
+	return;
+}
+int32_t Checkpoint_In::get_int(){
+	int32_t value = 0;
+	ifs.read((char*)&value,sizeof(value));
+	return value;
+}
+uint32_t Checkpoint_In::get_uint(){
+	uint32_t value = 0;
+	ifs.read((char*)&value,sizeof(value));
+	return value;
+}
+int64_t Checkpoint_In::get_int64(){
+	int64_t value = 0;
+	ifs.read((char*)&value,sizeof(value));
+	return value;
+}
+uint64_t Checkpoint_In::get_uint64(){
+	uint64_t value = 0;
+	ifs.read((char*)&value,sizeof(value));
+	return value;
+}
+double Checkpoint_In::get_double(){
+	double value = 0;
+	ifs.read((char*)&value,sizeof(value));
+	return value;
+}
+template<typename T>
+void Checkpoint_In::get_vector(vector<T>& values){
+	uint64_t size = get_uint64();
+	//a corrupt or truncated length fails here rather than in
+	//the allocation or the read
+	if(ifs.good() && (size > (length - (uint64_t)ifs.tellg())/sizeof(T))){
+		ifs.setstate(ios::failbit);
+	}
+	if(!ifs.good()){
+		values.clear();
+		return;
+	}
+	values.resize(size);
+	ifs.read((char*)values.data(),size*sizeof(T));
+	return;
+}
+template void Checkpoint_In::get_vector(vector<int>& values);
+template void Checkpoint_In::get_vector(vector<double>& values);
+template void Checkpoint_In::get_vector(vector<char>& values);
+template void Checkpoint_In::get_vector(vector<int64_t>& values);
@@ -0,0 +1,80 @@
+//checkpoint.h
+
+//*********************************************************
+// Include Guards
+#ifndef _CHECKPOINT_H_INCLUDED_
+#define _CHECKPOINT_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+
+//*********************************************************
+// include dependencies
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+using namespace std;
+//*********************************************************
+//Checkpoints hold everything needed to carry on a run exactly
+//where it stopped. The file is "YCHECKPT", a uint32 version and
+//0x01020304 in the writer's byte order, then whatever the classes
+//save in the order main, Colony, Mesh, Cell_Store and Cells
+//write it. main saves the run parameters first and refuses a
+//restart with others, then the force kernel, which only warns.
+//A restart must use the same binary.
+const char CHECKPOINT_MAGIC[8] = {'Y','C','H','E','C','K','P','T'};
+const uint32_t CHECKPOINT_VERSION = 5;
+
+//*********************************************************
+// Checkpoint_Out Class Declaration
+
+//Writes to filename.tmp and renames it over filename once
+//done, so a job killed mid write keeps its last checkpoint.
+class Checkpoint_Out {
+	private:
+		string filename;
+		ofstream ofs;
+	public:
+		//constructor
+		Checkpoint_Out(const string& filename);
+		void put(int32_t value);
+		void put(uint32_t value);
+		void put(int64_t value);
+		void put(uint64_t value);
+		void put(double value);
+		template<typename T> void put_vector(const vector<T>& values);
+		//returns false if anything failed to write
+		bool close();
+};
+
+//End Checkpoint_Out Class
+//**************************************************************
+// Checkpoint_In Class Declaration
+
+class Checkpoint_In {
+	private:
+		ifstream ifs;
+		//file size, a vector can not hold more than is left of it
+		uint64_t length;
+	public:
+		//constructor, checks the header
+		Checkpoint_In(const string& filename);
+		bool good() const {return ifs.good();}
+		//for contents that read fine but do not fit together
+		void fail() {ifs.setstate(ios::failbit);}
+		int32_t get_int();
+		uint32_t get_uint();
+		int64_t get_int64();
+		uint64_t get_uint64();
+		double get_double();
+		//fails the stream if the length read would run past the
+		//end of the file
+		template<typename T> void get_vector(vector<T>& values);
+};
+
+//End Checkpoint_In Class
+//**************************************************************
+#endif
+
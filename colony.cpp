@@ -11,6 +11,8 @@
 #include <cstdio>
 #include <memory>
 #include <random>
+#include <algorithm>
+#include <omp.h>
 
 #include "parameters.h"
 #include "coord.h"
@@ -22,13 +24,18 @@
 //Public Member Functions for Colony.cpp
 
 //constructor
-Colony::Colony(shared_ptr<Mesh> new_mesh, mt19937  gen) {
+Colony::Colony(shared_ptr<Mesh> new_mesh, uint64_t seed) : colony_stream(seed,COLONY_STREAM,0) {
 	this->my_mesh = new_mesh;
-	this->dist_generator = gen;
+	this->seed = seed;
+	this->sim_time = 0;
+	this->lists_since_reorder = 0;
+	this->listed_cells = 0;
+	this->awake_stale = true;
+	this->sleeper_shift = 0;
+	this->hertz_kernel = select_hertz_kernel();
 	return;
 }
 void Colony::make_founder_cell(){
-     shared_ptr<Colony> this_colony = shared_from_this();
      int num_cells = 0;
      if(!Start_from_four){
      //make founder cell
@@ -40,10 +47,9 @@ void Colony::make_founder_cell(){
      int rank = 0;
      init_radius = 0;
      center = Coord(0,0);
-     auto new_cell = make_shared<Cell>(this_colony, rank, center, init_radius, div_site);
-     update_colony_cell_vec(new_cell);
-     new_cell->set_mother(new_cell);
+     unique_ptr<Cell> new_cell(new Cell(this, rank, center, init_radius, div_site));
      new_cell->update_lineage_vec(rank); 
+     update_colony_cell_vec(move(new_cell));
      //make founder cell
      //variables needed to 
      //feed to cell constructor
@@ -55,10 +61,9 @@ void Colony::make_founder_cell(){
      int rank = 0;
      double init_radius = 0;
      Coord center = Coord(.1,.1);
-     auto new_cell1 = make_shared<Cell>(this_colony, rank, center, init_radius, div_site);
-     update_colony_cell_vec(new_cell1);
-     new_cell1->set_mother(new_cell1);
+     unique_ptr<Cell> new_cell1(new Cell(this, rank, center, init_radius, div_site));
      new_cell1->update_lineage_vec(rank);
+     update_colony_cell_vec(move(new_cell1));
      //make founder cell
      //variables needed to 
      //feed to cell constructor
@@ -68,10 +73,9 @@ void Colony::make_founder_cell(){
      rank = 1;
      init_radius = 0;
      center = Coord(.1,-.1);
-     auto new_cell2 = make_shared<Cell>(this_colony, rank, center, init_radius, div_site);
-     update_colony_cell_vec(new_cell2);
-     new_cell2->set_mother(new_cell2);
-     new_cell2->update_lineage_vec(rank); 
+     unique_ptr<Cell> new_cell2(new Cell(this, rank, center, init_radius, div_site));
+     new_cell2->update_lineage_vec(rank);
+     update_colony_cell_vec(move(new_cell2)); 
      //make founder cell
      //variables needed to 
      //feed to cell constructor
@@ -81,10 +85,9 @@ void Colony::make_founder_cell(){
      rank = 2;
      init_radius = 0;
      center = Coord(-.1,.1);
-     auto new_cell3 = make_shared<Cell>(this_colony, rank, center, init_radius, div_site);
-     update_colony_cell_vec(new_cell3);
-     new_cell3->set_mother(new_cell3);
-     new_cell3->update_lineage_vec(rank); 
+     unique_ptr<Cell> new_cell3(new Cell(this, rank, center, init_radius, div_site));
+     new_cell3->update_lineage_vec(rank);
+     update_colony_cell_vec(move(new_cell3)); 
      //make founder cell
      //variables needed to 
      //feed to cell constructor
@@ -94,10 +97,9 @@ void Colony::make_founder_cell(){
      rank = 3;
      init_radius = 0;
      center = Coord(-1.,-.1);
-     auto new_cell4 = make_shared<Cell>(this_colony, rank, center, init_radius, div_site);
-     update_colony_cell_vec(new_cell4);
-     new_cell4->set_mother(new_cell4);
+     unique_ptr<Cell> new_cell4(new Cell(this, rank, center, init_radius, div_site));
      new_cell4->update_lineage_vec(rank);
+     update_colony_cell_vec(move(new_cell4));
      }
      return;
 }
@@ -166,8 +168,7 @@ void Colony::make_founder_cell(){
 	return;
 }*/
 double Colony::uniform_random_real_number(double a, double b){
-	uniform_real_distribution<> dis(a,b);
-	return dis(this->dist_generator);
+	return colony_stream.uniform(a,b);
 }
 /*void Colony::match_up(){
 	for(unsigned int i = 0; i < cells.size(); i++){
@@ -182,12 +183,20 @@ double Colony::uniform_random_real_number(double a, double b){
 	return;
 }*/
 
-void Colony::get_colony_cell_vec(vector<shared_ptr<Cell>>& curr_cells){
-	curr_cells = my_cells;
-	return;
-}
-void Colony::update_colony_cell_vec(shared_ptr<Cell> new_cell){
-	my_cells.push_back(new_cell);
+void Colony::update_colony_cell_vec(unique_ptr<Cell> new_cell){
+	//the cell already holds its store entry, it is filed under
+	//the slot and rank it was given
+	int slot = new_cell->get_slot();
+	int rank = new_cell->get_rank();
+	if(my_cells.size() <= (unsigned int)slot){
+		my_cells.resize(slot+1);
+	}
+	if(slot_of_rank.size() <= (unsigned int)rank){
+		slot_of_rank.resize(rank+1);
+	}
+	slot_of_rank[rank] = slot;
+	my_cells[slot] = move(new_cell);
+	cell_store.protein_time[slot] = sim_time;
 	return;
 }
 int Colony::get_num_cells(){
@@ -195,63 +204,497 @@ int Colony::get_num_cells(){
 }
 void Colony::find_bin(){
 	//cout << "error in find bin?" << endl;
-	vector<shared_ptr<Mesh_Pt>> mesh_pts;
-	//cout << "get mesh" << endl;
-	my_mesh->get_mesh_pts_vec(mesh_pts);
-	//cout << "mesh pts loop" << endl;
-	#pragma omp parallel for schedule(static,1)
-	for(unsigned int i = 0; i< mesh_pts.size();i++){
-		mesh_pts.at(i)->clear_cells_vec();
+	//keys are computed in parallel, only cells that changed bin
+	//go through the mesh lookup, which may have to make the bin
+	int num_cells = cell_store.size();
+	vector<char> moved(num_cells);
+	#pragma omp parallel for schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		int64_t key = my_mesh->get_bin_key(Coord(cell_store.x[i],cell_store.y[i]));
+		moved[i] = key != cell_store.bin_key[i];
+		cell_store.bin_key[i] = key;
 	}
-	//cout << "mesh pts end loop" << endl;
-	//#pragma omp parallel for schedule(static,1)
-	for(unsigned int i = 0; i < my_cells.size(); i++){
-		my_cells.at(i)->find_bin();
-		//cout << "assigned id" << cells.at(i)->get_bin_id() <<" rank: " << cells.at(i)->get_rank() << endl;
+	for(int i = 0; i < num_cells; i++){
+		if(moved[i]){
+			cell_store.bin_id[i] = my_mesh->get_bin_index(cell_store.bin_key[i]);
+		}
+	}
+	update_cell_list();
+	return;
+}
+void Colony::update_cell_list(){
+	//rebuild the cell list the force loop reads from
+	//using the bin each cell was last assigned to, cells
+	//born since the lists were built are in it too so
+	//their mass counts toward their bin's nutrient
+	my_mesh->build_cell_list(cell_store.bin_id,cell_store.size());
+	return;
+}
+int Colony::count_neighbors(int cell, int* neighbors){
+	//scans the bin stencil for cells in higher slots within interaction
+	//range plus the skin, writes them out if neighbors is given
+	//so each pair is listed once, under its lower slot
+	double my_x = cell_store.x[cell];
+	double my_y = cell_store.y[cell];
+	double my_radius = cell_store.radius[cell];
+	const int* bins = my_mesh->get_stencil(cell_store.bin_id[cell]);
+	int count = 0;
+	for(int i = 0; i < STENCIL_SIZE; i++){
+		if(bins[i] < 0){
+			continue;
+		}
+		for(int other : my_mesh->get_cells_in_bin(bins[i])){
+			if(other <= cell){
+				continue;
+			}
+			double cutoff = my_radius + cell_store.radius[other] + ADH_RANGE + VERLET_SKIN;
+			double dx = my_x - cell_store.x[other];
+			double dy = my_y - cell_store.y[other];
+			if(dx*dx + dy*dy < cutoff*cutoff){
+				if(neighbors){
+					neighbors[count] = other;
+				}
+				count++;
+			}
+		}
+	}
+	return count;
+}
+void Colony::build_neighbor_lists(){
+	//every build counts toward the next reorder, whether the lists
+	//expired or cells were born, and the reorder goes first so the
+	//lists are made over the new order
+	if((REORDER_INTERVAL > 0) && (++lists_since_reorder >= REORDER_INTERVAL)){
+		reorder_cells();
+		lists_since_reorder = 0;
+	}
+	//bins must be current for the stencil scan to see every
+	//cell within range
+	listed_cells = my_cells.size();
+	find_bin();
+	int num_cells = my_cells.size();
+	nbr_offsets.resize(num_cells+1);
+	list_centers.resize(num_cells);
+	list_radii.resize(num_cells);
+	nbr_offsets[0] = 0;
+	#pragma omp parallel for schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		nbr_offsets[i+1] = count_neighbors(i,NULL);
+		list_centers[i] = Coord(cell_store.x[i],cell_store.y[i]);
+		list_radii[i] = cell_store.radius[i];
+	}
+	for(int i = 0; i < num_cells; i++){
+		nbr_offsets[i+1] += nbr_offsets[i];
+	}
+	nbr_list.resize(nbr_offsets[num_cells]);
+	#pragma omp parallel for schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		count_neighbors(i,&nbr_list[nbr_offsets[i]]);
+	}
+	index_reverse_pairs();
+	sleeper_shift = 0;
+	return;
+}
+void Colony::index_reverse_pairs(){
+	//counting sort of the pair positions by their listed neighbor,
+	//which keeps them in list order within each cell
+	int num_cells = max((int)nbr_offsets.size()-1,0);
+	reverse_offsets.assign(num_cells+1,0);
+	reverse_pairs.resize(nbr_list.size());
+	reverse_cells.resize(nbr_list.size());
+	for(int j : nbr_list){
+		reverse_offsets[j+1]++;
+	}
+	for(int i = 0; i < num_cells; i++){
+		reverse_offsets[i+1] += reverse_offsets[i];
+	}
+	vector<int> next(reverse_offsets.begin(),reverse_offsets.end()-1);
+	for(int i = 0; i < num_cells; i++){
+		for(int p = nbr_offsets[i]; p < nbr_offsets[i+1]; p++){
+			reverse_cells[next[nbr_list[p]]] = i;
+			reverse_pairs[next[nbr_list[p]]++] = p;
+		}
+	}
+	return;
+}
+double Colony::get_list_shift(int cell) const{
+	//how far a cell has moved plus grown since its list was made
+	double dx = cell_store.x[cell] - list_centers[cell].get_X();
+	double dy = cell_store.y[cell] - list_centers[cell].get_Y();
+	return sqrt(dx*dx + dy*dy) + cell_store.radius[cell] - list_radii[cell];
+}
+bool Colony::neighbor_lists_expired(){
+	//a listed pair can only come into range once the movement
+	//plus growth of its two cells adds up to more than the skin.
+	//Sleepers keep the shift they fell asleep with
+	if(awake_stale){
+		refresh_awake_cells();
+	}
+	int num_awake = awake_cells.size();
+	double max_shift = sleeper_shift;
+	#pragma omp parallel for reduction(max:max_shift) schedule(static)
+	for(int k = 0; k < num_awake; k++){
+		max_shift = max(max_shift,get_list_shift(awake_cells[k]));
+	}
+	return max_shift > .5*VERLET_SKIN;
+}
+void Colony::update_neighbor_lists(){
+	if((nbr_offsets.size() != my_cells.size()+1) || neighbor_lists_expired()){
+		build_neighbor_lists();
+	}
+	return;
+}
+void Colony::reorder_cells(){
+	//sorts storage along a Morton curve of the cells' bins so cells
+	//that interact are close in memory, ties go by rank so the order
+	//only depends on where the cells are
+	int num_cells = my_cells.size();
+	vector<pair<uint64_t,int>> keys(num_cells);
+	#pragma omp parallel for schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		int64_t bin_key = my_mesh->get_bin_key(Coord(cell_store.x[i],cell_store.y[i]));
+		keys[i] = make_pair(Mesh::get_morton_key(bin_key),i);
+	}
+	sort(keys.begin(),keys.end(),[this](const pair<uint64_t,int>& a, const pair<uint64_t,int>& b){
+		if(a.first != b.first){
+			return a.first < b.first;
+		}
+		return my_cells[a.second]->get_rank() < my_cells[b.second]->get_rank();
+	});
+	vector<int> order(num_cells);
+	vector<int> new_slot(num_cells);
+	bool moved = false;
+	for(int i = 0; i < num_cells; i++){
+		order[i] = keys[i].second;
+		new_slot[order[i]] = i;
+		moved = moved || (order[i] != i);
+	}
+	if(!moved){
+		return;
+	}
+	cell_store.permute(order);
+	awake_stale = true;
+	vector<unique_ptr<Cell>> moved_cells(num_cells);
+	for(int i = 0; i < num_cells; i++){
+		moved_cells[i] = move(my_cells[order[i]]);
+		moved_cells[i]->set_slot(i);
+		slot_of_rank[moved_cells[i]->get_rank()] = i;
+	}
+	my_cells.swap(moved_cells);
+	//everything else the colony keeps by slot follows the cells
+	for(unsigned int b = 0; b < bonds.size(); b++){
+		bonds[b].mother = new_slot[bonds[b].mother];
+		bonds[b].bud = new_slot[bonds[b].bud];
+	}
+	for(unsigned int k = 0; k < rekey_cells.size(); k++){
+		rekey_cells[k] = new_slot[rekey_cells[k]];
+	}
+	for(unsigned int k = 0; k < budding_cells.size(); k++){
+		budding_cells[k] = new_slot[budding_cells[k]];
+	}
+	for(unsigned int k = 0; k < mitosis_cells.size(); k++){
+		mitosis_cells[k] = new_slot[mitosis_cells[k]];
+	}
+	//every cell has its version once founders are scheduled,
+	//before that there are none to move
+	vector<int> moved_versions(event_version.size());
+	for(unsigned int i = 0; i < event_version.size(); i++){
+		moved_versions[i] = event_version[order[i]];
+	}
+	event_version.swap(moved_versions);
+	vector<Cycle_Event> events;
+	while(!cycle_events.empty()){
+		events.push_back(cycle_events.top());
+		cycle_events.pop();
+	}
+	for(Cycle_Event event : events){
+		event.cell = new_slot[event.cell];
+		cycle_events.push(event);
 	}
 	return;
 }
-void Colony::update_growth_rates(){
+void Colony::add_neighbor_list(int cell, int mother){
+	//a cell born after the lists were built gets a list of its own,
+	//put after the others, with every cell it could reach before the
+	//lists expire. Other cells are tested from where the lists last
+	//saw them, so the usual skin test covers the pair. Listed cells
+	//are found in the stencil of the mother's bin, which main checks
+	//is wide enough, and a pair of two new cells goes under the later
+	//one. The cell list may hold earlier new cells, those are skipped
+	//there and tested from their own centers
+	double my_x = cell_store.x[cell];
+	double my_y = cell_store.y[cell];
+	double my_radius = cell_store.radius[cell];
+	list_centers.push_back(Coord(my_x,my_y));
+	list_radii.push_back(my_radius);
+	auto in_range = [&](int other){
+		double cutoff = my_radius + list_radii[other] + ADH_RANGE + VERLET_SKIN;
+		double dx = my_x - list_centers[other].get_X();
+		double dy = my_y - list_centers[other].get_Y();
+		return dx*dx + dy*dy < cutoff*cutoff;
+	};
+	const int* bins = my_mesh->get_stencil(cell_store.bin_id[mother]);
+	for(int i = 0; i < STENCIL_SIZE; i++){
+		if(bins[i] < 0){
+			continue;
+		}
+		for(int other : my_mesh->get_cells_in_bin(bins[i])){
+			if((other < listed_cells) && in_range(other)){
+				nbr_list.push_back(other);
+			}
+		}
+	}
+	for(int other = listed_cells; other < cell; other++){
+		if(in_range(other)){
+			nbr_list.push_back(other);
+		}
+	}
+	nbr_offsets.push_back(nbr_list.size());
+	return;
+}
+Cell_Span Colony::get_neighbors(int cell) const{
+	Cell_Span span;
+	span.first = nbr_list.data() + nbr_offsets[cell];
+	span.last = nbr_list.data() + nbr_offsets[cell+1];
+	return span;
+}
+void Colony::update_growth_rates(double step_dt){
 	//cout << "error in find bin?" << endl;
-	vector<shared_ptr<Mesh_Pt>> mesh_pts;
-	//cout << "get mesh" << endl;
-	my_mesh->get_mesh_pts_vec(mesh_pts);
+	//a bin without cells loses no nutrient, so only the occupied
+	//bins are walked
+	const vector<int>& occupied_bins = my_mesh->get_occupied_bins();
+	int num_occupied = occupied_bins.size();
 	//cout << "mesh pts loop" << endl;
-	#pragma omp parallel for schedule(static,1)
-	for(unsigned int i = 0; i< mesh_pts.size();i++){
-		mesh_pts.at(i)->calculate_nutrient_concentration();
+	#pragma omp parallel for schedule(static)
+	for(int k = 0; k < num_occupied; k++){
+		int bin = occupied_bins[k];
+		double total_mass = 0;
+		for(int cell : my_mesh->get_cells_in_bin(bin)){
+			total_mass += M_PI*pow(cell_store.radius[cell],2);
+		}
+		my_mesh->get_mesh_pt(bin)->calculate_nutrient_concentration(total_mass,step_dt);
+	}
+	//cell cycle slows with the nutrient left in each cell's bin
+	int num_cells = cell_store.size();
+	vector<char> sped_up(num_cells);
+	#pragma omp parallel for schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		double cci = cell_store.theoretical_cci[i]*my_mesh->get_nutrient_conc(cell_store.bin_id[i]);
+		sped_up[i] = cci > cell_store.cell_cycle_increment[i];
+		cell_store.cell_cycle_increment[i] = cci;
 	}
-	#pragma omp parallel for schedule(static,1)
-	for(unsigned int i = 0; i< my_cells.size();i++){
-		my_cells.at(i)->update_growth_rate();
+	//slower cycles only make the queued events early, which is safe,
+	//but a cell that moved to a richer bin needs a new event
+	for(int i = 0; i < num_cells; i++){
+		if(sped_up[i]){
+			rekey_cells.push_back(i);
+		}
 	}
 	return;
 }
-void Colony::grow_cells(){
-	#pragma omp parallel for schedule(static,1)
-	for(unsigned int i = 0; i < my_cells.size(); i++){
-		my_cells.at(i)->grow_cell();
+int Colony::choose_time_step(int last_ticks, int max_ticks){
+	//number of dt ticks for the next step: at most double the last
+	//step, no cell moves or grows more than DT_TOLERANCE, and the
+	//step stops on the next phase change or max size so events
+	//happen on the same tick as with fixed steps. Velocities come
+	//from the forces of the last step
+	int num_cells = cell_store.size();
+	double max_rate = 0;
+	double event_ticks = max_ticks;
+	#pragma omp parallel for reduction(max:max_rate) reduction(min:event_ticks) schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		double growth = cell_store.at_max_size[i] ? 0.0 : cell_store.growth_rate[i];
+		max_rate = max(max_rate,get_speed(i,cell_store.force_x[i],cell_store.force_y[i]));
+		if(growth > 0){
+			event_ticks = min(event_ticks,ceil((cell_store.max_radius[i] - cell_store.radius[i])/(growth*dt)));
+		}
+		//a cell already past its threshold changes phase, buds or
+		//divides during this step, which is then a single tick
+		double remaining = 0;
+		if(cell_store.phase[i] == G1_PHASE){
+			remaining = cell_store.G1_threshold[i] - cell_store.CP[i];
+		}else if(cell_store.phase[i] == G2_PHASE){
+			remaining = 1 - cell_store.CP[i];
+		}
+		if(remaining <= 0){
+			event_ticks = 1;
+		}else if(cell_store.cell_cycle_increment[i] > 0){
+			event_ticks = min(event_ticks,ceil(remaining/(cell_store.cell_cycle_increment[i]*dt)));
+		}
+	}
+	double ticks = min((double)2*last_ticks,event_ticks);
+	if(max_rate > 0){
+		ticks = min(ticks,floor(DT_TOLERANCE/(max_rate*dt)));
+	}
+	return max((int)ticks,1);
+}
+void Colony::grow_cells(double step_dt){
+	int num_cells = cell_store.size();
+	double* radius = cell_store.radius.data();
+	const double* max_radius = cell_store.max_radius.data();
+	const double* growth_rate = cell_store.growth_rate.data();
+	char* at_max_size = cell_store.at_max_size.data();
+	#pragma omp parallel for simd schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		radius[i] += at_max_size[i] ? 0.0 : growth_rate[i]*step_dt;
+		at_max_size[i] = at_max_size[i] || (radius[i] >= max_radius[i]);
 	}
 	return;
 }
 
-void Colony::update_cell_cycles(int Ti){
-	#pragma omp parallel for schedule(static,1)
-	for(unsigned int i = 0; i < my_cells.size(); i++){
-		my_cells.at(i)->update_cell_cycle();
+void Colony::schedule_cycle_event(int cell, int Ti){
+	//CP grows by cell_cycle_increment*dt a tick, the event is put
+	//a tick early so rounding in the running sum can not make it late
+	double target;
+	if(cell_store.phase[cell] == G1_PHASE){
+		target = cell_store.G1_threshold[cell];
+	}else if(cell_store.phase[cell] == G2_PHASE){
+		target = 1;
+	}else{
+		return;
+	}
+	double increment = cell_store.cell_cycle_increment[cell]*dt;
+	if(increment <= 0){
+		//stalled, rescheduled when its rate goes back up
+		return;
+	}
+	double ticks_left = min(floor((target - cell_store.CP[cell])/increment) - 1,(double)NUM_STEPS);
+	Cycle_Event event;
+	event.tick = Ti + max((int)ticks_left,0);
+	event.cell = cell;
+	event.version = ++event_version[cell];
+	cycle_events.push(event);
+	return;
+}
+void Colony::schedule_founders(int Ti){
+	//founders, buds are scheduled when they are born
+	while((int)event_version.size() < cell_store.size()){
+		event_version.push_back(0);
+		schedule_cycle_event(event_version.size()-1,Ti);
+	}
+	return;
+}
+int Colony::ticks_to_next_event(int Ti){
+	//a biology step ends where the next event falls so CP is tested
+	//on the same tick as with single steps. Stale events on top
+	//would only shorten the step, so they are dropped here
+	schedule_founders(Ti);
+	while(!cycle_events.empty() && (cycle_events.top().version != event_version[cycle_events.top().cell])){
+		cycle_events.pop();
+	}
+	if(cycle_events.empty()){
+		return NUM_STEPS;
+	}
+	return max(cycle_events.top().tick - Ti,1);
+}
+void Colony::update_cell_cycles(int Ti, int ticks){
+	//phase changes are checked before CP advances, only for cells
+	//whose event is due
+	int num_cells = cell_store.size();
+	schedule_founders(Ti);
+	for(int cell : rekey_cells){
+		schedule_cycle_event(cell,Ti);
+	}
+	rekey_cells.clear();
+	budding_cells.clear();
+	mitosis_cells.clear();
+	while(!cycle_events.empty() && (cycle_events.top().tick <= Ti)){
+		Cycle_Event event = cycle_events.top();
+		cycle_events.pop();
+		int cell = event.cell;
+		if(event.version != event_version[cell]){
+			continue;
+		}
+		if((cell_store.phase[cell] == G1_PHASE) && (cell_store.CP[cell] >= cell_store.G1_threshold[cell])){
+			cell_store.phase[cell] = S_PHASE;
+			budding_cells.push_back(cell);
+		}else if((cell_store.phase[cell] == G2_PHASE) && (cell_store.CP[cell] >= 1)){
+			cell_store.phase[cell] = M_PHASE;
+			mitosis_cells.push_back(cell);
+		}else{
+			//early, check again closer to the crossing
+			schedule_cycle_event(cell,Ti+1);
+		}
+	}
+	//births take ranks in the order of their mothers' ranks
+	auto by_rank = [this](int a, int b){return my_cells[a]->get_rank() < my_cells[b]->get_rank();};
+	sort(budding_cells.begin(),budding_cells.end(),by_rank);
+	sort(mitosis_cells.begin(),mitosis_cells.end(),by_rank);
+	double step_dt = ticks*dt;
+	double* CP = cell_store.CP.data();
+	const double* cell_cycle_increment = cell_store.cell_cycle_increment.data();
+	int* T_age = cell_store.T_age.data();
+	#pragma omp parallel for simd schedule(static)
+	for(int i = 0; i < num_cells; i++){
+		T_age[i] += ticks;
+		CP[i] += cell_cycle_increment[i]*step_dt;
 	}
 	return;
 }
 
+template<int DIVISION>
 void Colony::perform_budding(int Ti){
-    //#pragma omp parallel for schedule(static,1)	
-    for(unsigned int i=0; i < my_cells.size(); i++){
-        if(my_cells.at(i)->is_S()){
-		my_cells.at(i)->perform_budding(Ti);
-        }
-     }
+    //buds are built in parallel into staged slots, the bud of the
+    //k-th mother in rank order gets rank num_cells+k, then they
+    //are appended in that order
+    int num_cells = my_cells.size();
+    int num_births = budding_cells.size();
+    if(num_births == 0){
+	return;
+    }
+    vector<int> birth_slots(num_births);
+    for(int k = 0; k < num_births; k++){
+	birth_slots[k] = cell_store.add_cell();
+    }
+    vector<unique_ptr<Cell>> births(num_births);
+    #pragma omp parallel for schedule(static)
+    for(int k = 0; k < num_births; k++){
+	births[k] = my_cells[budding_cells[k]]->template perform_budding<DIVISION>(Ti,num_cells+k,birth_slots[k]);
+    }
+    for(int k = 0; k < num_births; k++){
+	update_colony_cell_vec(move(births[k]));
+	add_bond(budding_cells[k],birth_slots[k]);
+	cell_store.asleep[budding_cells[k]] = false;
+	cell_store.quiet_steps[budding_cells[k]] = 0;
+	//mother moves on to G2
+	schedule_cycle_event(budding_cells[k],Ti);
+    }
+    //buds and woken mothers join the awake cells
+    awake_stale = true;
+    //buds get their events now, a reorder before the next
+    //update_cell_cycles moves them with everything else
+    event_version.resize(cell_store.size(),0);
+    for(int k = 0; k < num_births; k++){
+	schedule_cycle_event(birth_slots[k],Ti);
+    }
+    //new buds need neighbor lists before this step's forces, they
+    //are added to the current lists unless a mother has no bin of
+    //her own yet, having been born since the last build
+    bool rebuild = nbr_offsets.size() != (unsigned int)num_cells+1;
+    for(int k = 0; k < num_births; k++){
+	rebuild = rebuild || (budding_cells[k] >= listed_cells);
+    }
+    if(rebuild){
+	build_neighbor_lists();
+    }else{
+	for(int k = 0; k < num_births; k++){
+		add_neighbor_list(birth_slots[k],budding_cells[k]);
+	}
+	//buds are binned where they are once all the lists are
+	//added, a new bin would move the stencils they read
+	for(int k = 0; k < num_births; k++){
+		int bud = birth_slots[k];
+		cell_store.bin_key[bud] = my_mesh->get_bin_key(Coord(cell_store.x[bud],cell_store.y[bud]));
+		cell_store.bin_id[bud] = my_mesh->get_bin_index(cell_store.bin_key[bud]);
+	}
+	update_cell_list();
+	index_reverse_pairs();
+    }
 	return;
 }
+template void Colony::perform_budding<0>(int Ti);
+template void Colony::perform_budding<1>(int Ti);
+template void Colony::perform_budding<2>(int Ti);
 /*void Colony::pull_daughter(){
 	for(unsigned int i = 0; i < cells.size(); i++){
 		cells.at(i)->pull_daughter();
@@ -259,68 +702,570 @@ void Colony::perform_budding(int Ti){
 	return;
 }*/
 void Colony::perform_mitosis(int Ti){
-	//#pragma omp parallel for schedule(static,1)
-	for(unsigned int i = 0; i < my_cells.size(); i++){
-	    if(my_cells.at(i)->is_M()){
-		    my_cells.at(i)->perform_mitosis(Ti);
+	//each division touches only the mother and its bud, except a bud
+	//dividing in the same step as its own mother, which has to see
+	//the protein its mother gives it. Those go in a serial pass after
+	int num_divisions = mitosis_cells.size();
+	if(num_divisions == 0){
+		return;
+	}
+	vector<char> after_mother(num_divisions);
+	for(int k = 0; k < num_divisions; k++){
+		Cell& cell = *my_cells[mitosis_cells[k]];
+		after_mother[k] = cell.bud_status() && (cell_store.phase[slot_of_rank[cell.get_mother_rank()]] == M_PHASE);
+	}
+	#pragma omp parallel for schedule(static)
+	for(int k = 0; k < num_divisions; k++){
+		if(!after_mother[k]){
+			my_cells[mitosis_cells[k]]->perform_mitosis(Ti);
 		}
-    }
+	}
+	for(int k = 0; k < num_divisions; k++){
+		if(after_mother[k]){
+			my_cells[mitosis_cells[k]]->perform_mitosis(Ti);
+		}
+	}
+	for(int cell : mitosis_cells){
+		remove_bond(cell,slot_of_rank[my_cells[cell]->get_curr_bud()]);
+		//mother starts over in G1
+		schedule_cycle_event(cell,Ti);
+	}
 	return;
 }
-void Colony::update_protein_concentration(){
-   #pragma omp parallel for schedule(static,1) 
-   for(unsigned int i=0; i< my_cells.size(); i++){
-        //cout << "Protein before" << cells.at(i)->get_protein_conc() << endl;
-        my_cells.at(i)->compute_protein_concentration();
-	//cout << "Protein after" << cells.at(i)->get_protein_conc() << endl;
-    }
+void Colony::advance_time(double step_dt){
+	//protein is not stepped with the rest of the colony, each
+	//cell catches up to sim_time when its protein is read
+	sim_time += step_dt;
+	return;
+}
+static double protein_rate(double p){
+	//logistic growth with an Allee threshold
+	return r_LOGISTIC*p*(1-p/K_LOGISTIC)*(p/A_LOGISTIC -1);
+}
+void Colony::update_protein(int cell){
+	//classic RK4 from protein_time to now, buds hold their protein
+	double elapsed = sim_time - cell_store.protein_time[cell];
+	cell_store.protein_time[cell] = sim_time;
+	if(cell_store.is_bud[cell] || (elapsed <= 0)){
+		return;
+	}
+	int num_steps = ceil(elapsed/PROTEIN_STEP);
+	double h = elapsed/num_steps;
+	double p = cell_store.protein[cell];
+	for(int k = 0; k < num_steps; k++){
+		double k1 = protein_rate(p);
+		double k2 = protein_rate(p + .5*h*k1);
+		double k3 = protein_rate(p + .5*h*k2);
+		double k4 = protein_rate(p + h*k3);
+		p += (h/6)*(k1 + 2*k2 + 2*k3 + k4);
+	}
+	cell_store.protein[cell] = p;
 	return;
 }
+double Colony::get_protein(int cell){
+	update_protein(cell);
+	return cell_store.protein[cell];
+}
 /*shared_ptr<Cell> Colony::return_cell(int cell_rank){
 	return this->cells.at(cell_rank);
 }*/
-void Colony::update_locations(){
+void Colony::refresh_awake_cells(){
+	awake_cells.clear();
+	for(int i = 0; i < cell_store.size(); i++){
+		if(!cell_store.asleep[i]){
+			awake_cells.push_back(i);
+		}
+	}
+	awake_stale = false;
+	return;
+}
+void Colony::find_boundary_sleepers(){
+	//only sleepers listed with an awake cell feel any force, the
+	//pairs of two sleepers are left as they are
+	boundary_sleepers.clear();
+	if((int)awake_cells.size() == cell_store.size()){
+		return;
+	}
+	int num_awake = awake_cells.size();
+	#pragma omp parallel
+	{
+		vector<int> found;
+		#pragma omp for schedule(static) nowait
+		for(int k = 0; k < num_awake; k++){
+			int i = awake_cells[k];
+			for(int j : get_neighbors(i)){
+				if(cell_store.asleep[j]){
+					found.push_back(j);
+				}
+			}
+			for(int r = reverse_offsets[i]; r < reverse_offsets[i+1]; r++){
+				if(cell_store.asleep[reverse_cells[r]]){
+					found.push_back(reverse_cells[r]);
+				}
+			}
+		}
+		#pragma omp critical
+		boundary_sleepers.insert(boundary_sleepers.end(),found.begin(),found.end());
+	}
+	sort(boundary_sleepers.begin(),boundary_sleepers.end());
+	boundary_sleepers.erase(unique(boundary_sleepers.begin(),boundary_sleepers.end()),boundary_sleepers.end());
+	return;
+}
+void Colony::compute_forces(){
+	//each listed pair is evaluated once into its own entry, then
+	//every cell adds up its own pairs and takes away the pairs that
+	//list it, both in list order. The sums are the same for any
+	//number of threads, at the cost of two doubles per pair.
+	//Only the awake cells and the sleepers next to them are walked
+	if(awake_stale){
+		refresh_awake_cells();
+	}
+	find_boundary_sleepers();
+	const vector<int>* owners = &awake_cells;
+	if(!boundary_sleepers.empty()){
+		force_cells.resize(awake_cells.size() + boundary_sleepers.size());
+		merge(awake_cells.begin(),awake_cells.end(),boundary_sleepers.begin(),boundary_sleepers.end(),force_cells.begin());
+		owners = &force_cells;
+	}
+	int num_owners = owners->size();
+	int num_awake = awake_cells.size();
+	int num_boundary = boundary_sleepers.size();
+	int num_pairs = nbr_list.size();
+	pair_force_x.resize(num_pairs);
+	pair_force_y.resize(num_pairs);
+	sleeper_load.resize(cell_store.size());
+	#pragma omp parallel
+	{
+		//neighbors of one cell are gathered into contiguous
+		//blocks so the kernel can work on them a vector at a time
+		vector<double> nbr_x, nbr_y, nbr_radius, pair_x, pair_y;
+		vector<int> pairs;
+		#pragma omp for schedule(static)
+		for(int k = 0; k < num_owners; k++){
+			int i = (*owners)[k];
+			pairs.clear();
+			for(int p = nbr_offsets[i]; p < nbr_offsets[i+1]; p++){
+				//two sleeping cells are left as they are
+				if(!(cell_store.asleep[i] && cell_store.asleep[nbr_list[p]])){
+					pairs.push_back(p);
+				}
+			}
+			int num_neighbors = pairs.size();
+			if(num_neighbors == 0){
+				continue;
+			}
+			nbr_x.resize(num_neighbors);
+			nbr_y.resize(num_neighbors);
+			nbr_radius.resize(num_neighbors);
+			pair_x.resize(num_neighbors);
+			pair_y.resize(num_neighbors);
+			for(int n = 0; n < num_neighbors; n++){
+				int j = nbr_list[pairs[n]];
+				nbr_x[n] = cell_store.x[j];
+				nbr_y[n] = cell_store.y[j];
+				nbr_radius[n] = cell_store.radius[j];
+			}
+			hertz_kernel(cell_store.x[i],cell_store.y[i],cell_store.radius[i],nbr_x.data(),nbr_y.data(),nbr_radius.data(),num_neighbors,pair_x.data(),pair_y.data());
+			for(int n = 0; n < num_neighbors; n++){
+				pair_force_x[pairs[n]] = pair_x[n];
+				pair_force_y[pairs[n]] = pair_y[n];
+			}
+		}
+		#pragma omp for schedule(static) nowait
+		for(int k = 0; k < num_awake; k++){
+			int i = awake_cells[k];
+			double total_x = 0;
+			double total_y = 0;
+			for(int p = nbr_offsets[i]; p < nbr_offsets[i+1]; p++){
+				total_x += pair_force_x[p];
+				total_y += pair_force_y[p];
+			}
+			for(int r = reverse_offsets[i]; r < reverse_offsets[i+1]; r++){
+				total_x -= pair_force_x[reverse_pairs[r]];
+				total_y -= pair_force_y[reverse_pairs[r]];
+			}
+			cell_store.force_x[i] = total_x;
+			cell_store.force_y[i] = total_y;
+		}
+		//a sleeping cell does not move, what its awake neighbors
+		//push it with is kept to decide when it wakes
+		#pragma omp for schedule(static)
+		for(int k = 0; k < num_boundary; k++){
+			int i = boundary_sleepers[k];
+			double total_x = 0;
+			double total_y = 0;
+			for(int p = nbr_offsets[i]; p < nbr_offsets[i+1]; p++){
+				if(!cell_store.asleep[nbr_list[p]]){
+					total_x += pair_force_x[p];
+					total_y += pair_force_y[p];
+				}
+			}
+			for(int r = reverse_offsets[i]; r < reverse_offsets[i+1]; r++){
+				if(!cell_store.asleep[reverse_cells[r]]){
+					total_x -= pair_force_x[reverse_pairs[r]];
+					total_y -= pair_force_y[reverse_pairs[r]];
+				}
+			}
+			sleeper_load[i] = sqrt(total_x*total_x + total_y*total_y);
+		}
+	}
+	return;
+}
+void Colony::compute_bond_forces(){
+	//spring between each mother and its bud, rest length is the
+	//sum of their current radii. There are few bonds and a bud that
+	//starts budding early sits in two of them, so this stays serial
+	int num_bonds = bonds.size();
+	const Bond* bond = bonds.data();
+	double* force_x = cell_store.force_x.data();
+	double* force_y = cell_store.force_y.data();
+	const double* x = cell_store.x.data();
+	const double* y = cell_store.y.data();
+	const double* radius = cell_store.radius.data();
+	for(int b = 0; b < num_bonds; b++){
+		int mother = bond[b].mother;
+		int bud = bond[b].bud;
+		double v_x = x[mother] - x[bud];
+		double v_y = y[mother] - y[bud];
+		double d_ij = sqrt(v_x*v_x + v_y*v_y);
+		double spring = -K_ADH*(d_ij - (radius[mother] + radius[bud]));
+		force_x[mother] += v_x*spring;
+		force_y[mother] += v_y*spring;
+		force_x[bud] -= v_x*spring;
+		force_y[bud] -= v_y*spring;
+	}
+	return;
+}
+void Colony::add_bond(int mother, int bud){
+	Bond bond;
+	bond.mother = mother;
+	bond.bud = bud;
+	bonds.push_back(bond);
+	return;
+}
+void Colony::remove_bond(int mother, int bud){
+	//keeps the remaining bonds in order so the force sums
+	//do not depend on which buds separated first
+	for(unsigned int b = 0; b < bonds.size(); b++){
+		if((bonds[b].mother == mother) && (bonds[b].bud == bud)){
+			bonds.erase(bonds.begin() + b);
+			break;
+		}
+	}
+	return;
+}
+template<int BUDDING>
+void Colony::update_locations(double step_dt){
 	//cout << "in colony" << endl;
-	//cout << cells.size() << endl;
-	//double force_check = 0;
-	//int counter = 0;
-	//do {
-	//force_check = 0;
-//	#pragma omp parallel 
-//	{
-		//#pragma omp for reduction(+:force_check) schedule(static,1)
-		#pragma omp parallel for schedule(static,1)
-		for(unsigned int i = 0; i < my_cells.size(); i++){
-			//cout <<"cell: "<< i << endl;
-			//cells.at(i)->calc_forces_chou();
-			//cout << "update forces" << i <<  endl;
-			my_cells.at(i)->get_cell_force();
-			//force_check+= cells.at(i)->get_curr_force().length();
-			//counter++;
-			//cells.at(i)->pull_daughter();
-			//cout << "forces updated" << i << endl;
-			//cells.at(i)->calc_forces_jonsson();
-			//cout << "forces updated" << endl;
-			//cells.at(i)->calc_forces_exponential();
-	        	//cells.at(i)->lennard_jones_potential();
-        	}
-//	}
-	#pragma omp parallel for schedule(static,1)
-        for(unsigned int i = 0; i < my_cells.size(); i++){
-		//cout << "update locations" << endl;
-	        my_cells.at(i)->update_location();
-		//cout << "locations updated" << endl;
+	compute_forces();
+	if(BUDDING){
+		compute_bond_forces();
+	}
+	//overdamped motion, drag grows with cell radius,
+	//sleeping cells stay where they are
+	int num_awake = awake_cells.size();
+	const int* awake = awake_cells.data();
+	double* x = cell_store.x.data();
+	double* y = cell_store.y.data();
+	const double* radius = cell_store.radius.data();
+	const double* force_x = cell_store.force_x.data();
+	const double* force_y = cell_store.force_y.data();
+	#pragma omp parallel for schedule(static)
+	for(int k = 0; k < num_awake; k++){
+		int i = awake[k];
+		double mobility = (1.0/(1.0+eta*radius[i]))*step_dt;
+		x[i] += force_x[i]*mobility;
+		y[i] += force_y[i]*mobility;
+	}
+	if(SLEEP_SPEED > 0){
+		update_sleep();
 	}
 	//} while((force_check > 100));
     return;
 }
-void Colony::write_data(ofstream& ofs){
-    ofs << my_cells.size() << endl;
-    for(unsigned int i = 0; i < my_cells.size();i++){
-        my_cells.at(i)->print_txt_file_format(ofs);
+void Colony::update_sleep(){
+	//a cell moving or growing at SLEEP_SPEED or more wakes every
+	//sleeper it is listed with, a full grown G1 cell with no bud
+	//that stays slower than that for SLEEP_STEPS steps falls asleep.
+	//A sleeper pushed hard enough to move that fast wakes itself.
+	//Nothing else reaches a sleeper, so only the awake cells and
+	//the sleepers next to them are walked
+	int num_awake = awake_cells.size();
+	int num_boundary = boundary_sleepers.size();
+	vector<int> woken;
+	vector<int> fallen;
+	#pragma omp parallel
+	{
+		vector<int> my_woken;
+		vector<int> my_fallen;
+		#pragma omp for schedule(static) nowait
+		for(int k = 0; k < num_boundary; k++){
+			int i = boundary_sleepers[k];
+			if(get_speed(i,sleeper_load[i],0.0) >= SLEEP_SPEED){
+				my_woken.push_back(i);
+			}
+		}
+		//flags change once every cell has been tested, a cell
+		//falling asleep now is not woken by this step's movers
+		#pragma omp for schedule(static) nowait
+		for(int k = 0; k < num_awake; k++){
+			int i = awake_cells[k];
+			bool moving = get_speed(i,cell_store.force_x[i],cell_store.force_y[i]) >= SLEEP_SPEED;
+			if(moving){
+				for(int j : get_neighbors(i)){
+					if(cell_store.asleep[j]){
+						my_woken.push_back(j);
+					}
+				}
+				for(int r = reverse_offsets[i]; r < reverse_offsets[i+1]; r++){
+					if(cell_store.asleep[reverse_cells[r]]){
+						my_woken.push_back(reverse_cells[r]);
+					}
+				}
+			}
+			bool still = !moving && cell_store.at_max_size[i] && (cell_store.phase[i] == G1_PHASE) && !cell_store.is_bud[i];
+			if(!still){
+				cell_store.quiet_steps[i] = 0;
+			}else if(++cell_store.quiet_steps[i] >= SLEEP_STEPS){
+				my_fallen.push_back(i);
+			}
+		}
+		#pragma omp critical
+		{
+			woken.insert(woken.end(),my_woken.begin(),my_woken.end());
+			fallen.insert(fallen.end(),my_fallen.begin(),my_fallen.end());
+		}
+	}
+	if(woken.empty() && fallen.empty()){
+		return;
+	}
+	for(int i : fallen){
+		cell_store.asleep[i] = true;
+		cell_store.force_x[i] = 0;
+		cell_store.force_y[i] = 0;
+		sleeper_shift = max(sleeper_shift,get_list_shift(i));
+	}
+	awake_cells.erase(remove_if(awake_cells.begin(),awake_cells.end(),[this](int i){return (bool)cell_store.asleep[i];}),awake_cells.end());
+	sort(woken.begin(),woken.end());
+	woken.erase(unique(woken.begin(),woken.end()),woken.end());
+	for(int i : woken){
+		cell_store.asleep[i] = false;
+		cell_store.quiet_steps[i] = 0;
+	}
+	int num_kept = awake_cells.size();
+	awake_cells.insert(awake_cells.end(),woken.begin(),woken.end());
+	inplace_merge(awake_cells.begin(),awake_cells.begin()+num_kept,awake_cells.end());
+	return;
+}
+//without and with the mother-bud spring
+template void Colony::update_locations<0>(double step_dt);
+template void Colony::update_locations<1>(double step_dt);
+double Colony::get_speed(int cell, double force_x, double force_y) const{
+	double mobility = 1.0/(1.0+eta*cell_store.radius[cell]);
+	double force = sqrt(force_x*force_x + force_y*force_y);
+	double growth = cell_store.at_max_size[cell] ? 0.0 : cell_store.growth_rate[cell];
+	return force*mobility + growth;
+}
+void Colony::take_snapshot(Snapshot& frame, int Ti){
+    int num_cells = my_cells.size();
+    frame.tick = Ti;
+    frame.sim_time = sim_time;
+    frame.resize(num_cells);
+    //rows stay in rank order whatever the storage order
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < num_cells; i++){
+	update_protein(slot_of_rank[i]);
+	Cell& cell = *my_cells[slot_of_rank[i]];
+	cell.copy_to_snapshot(frame,i);
+	frame.lineage_offsets[i+1] = cell.get_lineage().size();
+	frame.g_lineage_offsets[i+1] = cell.get_griesemer_lineage().size();
+    }
+    frame.lineage_offsets[0] = 0;
+    frame.g_lineage_offsets[0] = 0;
+    for(int i = 0; i < num_cells; i++){
+	frame.lineage_offsets[i+1] += frame.lineage_offsets[i];
+	frame.g_lineage_offsets[i+1] += frame.g_lineage_offsets[i];
+    }
+    frame.lineage.resize(frame.lineage_offsets[num_cells]);
+    frame.g_lineage.resize(frame.g_lineage_offsets[num_cells]);
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < num_cells; i++){
+	Cell& cell = *my_cells[slot_of_rank[i]];
+	copy(cell.get_lineage().begin(),cell.get_lineage().end(),frame.lineage.begin() + frame.lineage_offsets[i]);
+	copy(cell.get_griesemer_lineage().begin(),cell.get_griesemer_lineage().end(),frame.g_lineage.begin() + frame.g_lineage_offsets[i]);
     }
     return;
 }
+void Colony::save(Checkpoint_Out& out){
+	colony_stream.save(out);
+	out.put(sim_time);
+	out.put((int32_t)lists_since_reorder);
+	out.put((int32_t)listed_cells);
+	my_mesh->save(out);
+	cell_store.save(out);
+	out.put((uint64_t)my_cells.size());
+	for(unsigned int i = 0; i < my_cells.size(); i++){
+		my_cells[i]->save(out);
+	}
+	out.put_vector(slot_of_rank);
+	//neighbor lists are kept as they are, a rebuild could list
+	//pairs in another order and change the force sums
+	vector<double> list_x(list_centers.size());
+	vector<double> list_y(list_centers.size());
+	for(unsigned int i = 0; i < list_centers.size(); i++){
+		list_x[i] = list_centers[i].get_X();
+		list_y[i] = list_centers[i].get_Y();
+	}
+	out.put_vector(nbr_offsets);
+	out.put_vector(nbr_list);
+	out.put_vector(list_x);
+	out.put_vector(list_y);
+	out.put_vector(list_radii);
+	out.put(sleeper_shift);
+	vector<int> bond_cells;
+	for(const Bond& bond : bonds){
+		bond_cells.push_back(bond.mother);
+		bond_cells.push_back(bond.bud);
+	}
+	out.put_vector(bond_cells);
+	vector<int> events;
+	priority_queue<Cycle_Event,vector<Cycle_Event>,greater<Cycle_Event>> queued = cycle_events;
+	while(!queued.empty()){
+		events.push_back(queued.top().tick);
+		events.push_back(queued.top().cell);
+		events.push_back(queued.top().version);
+		queued.pop();
+	}
+	out.put_vector(events);
+	out.put_vector(event_version);
+	out.put_vector(rekey_cells);
+	out.put_vector(budding_cells);
+	out.put_vector(mitosis_cells);
+	return;
+}
+void Colony::load(Checkpoint_In& in){
+	colony_stream.load(in);
+	sim_time = in.get_double();
+	lists_since_reorder = in.get_int();
+	listed_cells = in.get_int();
+	my_mesh->load(in);
+	cell_store.load(in);
+	uint64_t num_cells = in.get_uint64();
+	my_cells.clear();
+	for(uint64_t i = 0; (i < num_cells) && in.good(); i++){
+		my_cells.push_back(unique_ptr<Cell>(new Cell(this,in)));
+	}
+	in.get_vector(slot_of_rank);
+	vector<double> list_x;
+	vector<double> list_y;
+	in.get_vector(nbr_offsets);
+	in.get_vector(nbr_list);
+	in.get_vector(list_x);
+	in.get_vector(list_y);
+	in.get_vector(list_radii);
+	sleeper_shift = in.get_double();
+	awake_stale = true;
+	list_centers.clear();
+	for(unsigned int i = 0; (i < list_x.size()) && (i < list_y.size()); i++){
+		list_centers.push_back(Coord(list_x[i],list_y[i]));
+	}
+	vector<int> bond_cells;
+	in.get_vector(bond_cells);
+	bonds.clear();
+	for(unsigned int i = 0; i+1 < bond_cells.size(); i += 2){
+		add_bond(bond_cells[i],bond_cells[i+1]);
+	}
+	vector<int> events;
+	in.get_vector(events);
+	cycle_events = priority_queue<Cycle_Event,vector<Cycle_Event>,greater<Cycle_Event>>();
+	for(unsigned int i = 0; i+2 < events.size(); i += 3){
+		Cycle_Event event;
+		event.tick = events[i];
+		event.cell = events[i+1];
+		event.version = events[i+2];
+		cycle_events.push(event);
+	}
+	in.get_vector(event_version);
+	in.get_vector(rekey_cells);
+	in.get_vector(budding_cells);
+	in.get_vector(mitosis_cells);
+	if(in.good() && !check_loaded_state()){
+		in.fail();
+	}
+	//the cell list comes from the saved bins
+	if(in.good()){
+		update_cell_list();
+		index_reverse_pairs();
+	}
+	return;
+}
+bool Colony::check_loaded_state() const{
+	int num_cells = cell_store.size();
+	auto is_slot = [num_cells](int slot){return (slot >= 0) && (slot < num_cells);};
+	if(((int)my_cells.size() != num_cells) || ((int)slot_of_rank.size() != num_cells)){
+		return false;
+	}
+	//no versions are kept until the founders are scheduled
+	if(!event_version.empty() && ((int)event_version.size() != num_cells)){
+		return false;
+	}
+	if(event_version.empty() && !cycle_events.empty()){
+		return false;
+	}
+	for(int rank = 0; rank < num_cells; rank++){
+		int slot = slot_of_rank[rank];
+		if(!is_slot(slot) || (my_cells[slot]->get_slot() != slot) || (my_cells[slot]->get_rank() != rank)){
+			return false;
+		}
+	}
+	int num_bins = my_mesh->get_num_bins();
+	for(int i = 0; i < num_cells; i++){
+		if((cell_store.bin_id[i] < 0) || (cell_store.bin_id[i] >= num_bins)){
+			return false;
+		}
+	}
+	//lists run in order over every cell and only name cells
+	if((listed_cells < 0) || (listed_cells > num_cells) || ((int)nbr_offsets.size() != num_cells+1)){
+		return false;
+	}
+	if((nbr_offsets[0] != 0) || (nbr_offsets[num_cells] != (int)nbr_list.size())){
+		return false;
+	}
+	for(int i = 0; i < num_cells; i++){
+		if(nbr_offsets[i] > nbr_offsets[i+1]){
+			return false;
+		}
+	}
+	for(int j : nbr_list){
+		if(!is_slot(j)){
+			return false;
+		}
+	}
+	if(((int)list_centers.size() != num_cells) || ((int)list_radii.size() != num_cells)){
+		return false;
+	}
+	for(const Bond& bond : bonds){
+		if(!is_slot(bond.mother) || !is_slot(bond.bud)){
+			return false;
+		}
+	}
+	priority_queue<Cycle_Event,vector<Cycle_Event>,greater<Cycle_Event>> queued = cycle_events;
+	while(!queued.empty()){
+		if(!is_slot(queued.top().cell)){
+			return false;
+		}
+		queued.pop();
+	}
+	const vector<int>* cell_lists[] = {&rekey_cells,&budding_cells,&mitosis_cells};
+	for(const vector<int>* cells : cell_lists){
+		for(int cell : *cells){
+			if(!is_slot(cell)){
+				return false;
+			}
+		}
+	}
+	return true;
+}
 /*void Colony::print_vtk_file(ofstream& ofs){
 	vector<shared_ptr<Cell>> colony_cells;
 	get_Cells(colony_cells);
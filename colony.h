@@ -17,28 +17,124 @@
 #include <math.h>
 #include <ctime>
 #include <cstdio>
-#include <boost/enable_shared_from_this.hpp>
-#include <boost/shared_ptr.hpp>
 #include <memory>
 #include <random>
+#include <queue>
 
 #include "parameters.h"
 #include "coord.h"
 #include "cell.h"
+#include "cell_store.h"
 #include "mesh.h"
+#include "force_kernel.h"
+#include "philox.h"
+#include "snapshot.h"
+#include "checkpoint.h"
 #include "externs.h"
 //******************************************
+//mother-bud spring, created at budding and
+//retired at mitosis
+struct Bond {
+	int mother;
+	int bud;
+};
+//******************************************
+//earliest tick a cell can reach its next phase check,
+//stale once the cell gets a newer event
+struct Cycle_Event {
+	int tick;
+	int cell;
+	int version;
+	bool operator>(const Cycle_Event& other) const {
+		return (tick > other.tick) || ((tick == other.tick) && (cell > other.cell));
+	}
+};
+//******************************************
 //COLONY Class Declaration
 
-class Colony: public enable_shared_from_this<Colony>{
+class Colony {
 	private:
 		shared_ptr<Mesh> my_mesh;
-		mt19937 dist_generator;
-		vector<shared_ptr<Cell>> my_cells;
-		
+		uint64_t seed;
+		//draws made by the colony itself, founders only
+		Random_Stream colony_stream;
+		//the colony is the only owner of its cells, cells
+		//refer to each other by rank. Cells and their store
+		//entries are indexed by slot, which equals rank until
+		//the first reorder
+		vector<unique_ptr<Cell>> my_cells;
+		vector<int> slot_of_rank;
+		//per step cell state, indexed by slot
+		Cell_Store cell_store;
+		//neighbor list builds since storage was last reordered
+		int lists_since_reorder;
+		//minutes simulated so far
+		double sim_time;
+		//verlet lists: neighbors of cell i are nbr_list[nbr_offsets[i]..nbr_offsets[i+1])
+		vector<int> nbr_offsets;
+		vector<int> nbr_list;
+		//cell centers and radii when the lists were last built
+		vector<Coord> list_centers;
+		vector<double> list_radii;
+		//cells the lists and bins were built over, cells born since
+		//have lists of their own appended after them
+		int listed_cells;
+		//force of each listed pair on its first cell, by position
+		//in nbr_list, and for each cell the positions of the pairs
+		//that list it as the neighbor and the cells that list it:
+		//reverse_pairs[reverse_offsets[j]..reverse_offsets[j+1])
+		vector<double> pair_force_x;
+		vector<double> pair_force_y;
+		vector<int> reverse_offsets;
+		vector<int> reverse_pairs;
+		vector<int> reverse_cells;
+		//size of the contact force on each sleeping cell, which
+		//is not applied but wakes the cell once it is large enough
+		vector<double> sleeper_load;
+		//cells the mechanics passes walk, in slot order: the awake
+		//cells and the sleepers listed with one of them, either way
+		//round. The awake list is remade from the flags once cells
+		//are born, reordered or loaded
+		vector<int> awake_cells;
+		vector<int> boundary_sleepers;
+		vector<int> force_cells;
+		bool awake_stale;
+		//largest list shift of a cell that fell asleep since the
+		//lists were built, sleepers do not move or grow
+		double sleeper_shift;
+		//one entry per mother still attached to its bud, by slot
+		vector<Bond> bonds;
+		//cell cycle events, soonest first
+		priority_queue<Cycle_Event,vector<Cycle_Event>,greater<Cycle_Event>> cycle_events;
+		//latest event per cell, older ones in the queue are skipped
+		vector<int> event_version;
+		//cells whose cycle sped up after their event was scheduled
+		vector<int> rekey_cells;
+		//cells that entered S or M this step, in rank order
+		vector<int> budding_cells;
+		vector<int> mitosis_cells;
+		//contact force kernel for this cpu, set at construction
+		Hertz_Kernel hertz_kernel;
+		int count_neighbors(int cell, int* neighbors);
+		void schedule_cycle_event(int cell, int Ti);
+		void schedule_founders(int Ti);
+		void compute_forces();
+		void compute_bond_forces();
+		void reorder_cells();
+		void add_neighbor_list(int cell, int mother);
+		void index_reverse_pairs();
+		double get_list_shift(int cell) const;
+		void refresh_awake_cells();
+		void find_boundary_sleepers();
+		void update_sleep();
+		//whether what load read fits together, every slot and rank
+		//it holds must index the cells before anything uses them
+		bool check_loaded_state() const;
+		//how fast a cell moves under force and grows
+		double get_speed(int cell, double force_x, double force_y) const;
 	public:
 		//constructor
-		Colony(shared_ptr<Mesh> my_mesh, mt19937 gen);
+		Colony(shared_ptr<Mesh> my_mesh, uint64_t seed);
         	//Colony(shared_ptr<Mesh> my_mesh);
 		//make founder cell
         	//void make_founder_cell(string filename);
@@ -46,24 +142,48 @@ class Colony: public enable_shared_from_this<Colony>{
 		//void make_founder_cell(string filename);
 		double uniform_random_real_number(double a, double b);
 		//getters and setters
-		void get_colony_cell_vec(vector<shared_ptr<Cell>>& curr_cells);
-		void update_colony_cell_vec(shared_ptr<Cell> new_cell);
+		void update_colony_cell_vec(unique_ptr<Cell> new_cell);
+		void add_bond(int mother, int bud);
+		void remove_bond(int mother, int bud);
 		int get_num_cells();
-		shared_ptr<Mesh> get_mesh(){return my_mesh;}
-		//cell actions
+		Cell& get_cell(int rank){return *my_cells[slot_of_rank[rank]];}
+		const shared_ptr<Mesh>& get_mesh(){return my_mesh;}
+		Cell_Store& get_store(){return cell_store;}
+		double get_time(){return sim_time;}
+		uint64_t get_seed(){return seed;}
+		const char* get_force_kernel_name(){return hertz_kernel_name(hertz_kernel);}
+		//cell actions, the templated ones are specialized on the
+		//model switches (Budding_On, Division_Pattern) and picked
+		//once in main
 		void find_bin();
+		void update_cell_list();
+		void build_neighbor_lists();
+		bool neighbor_lists_expired();
+		void update_neighbor_lists();
+		Cell_Span get_neighbors(int cell) const;
 		//void pull_daughter();
-		void grow_cells();
-		void update_cell_cycles(int Ti);
-        	void perform_budding(int Ti);
+		int choose_time_step(int last_ticks, int max_ticks);
+		void grow_cells(double step_dt);
+		void update_cell_cycles(int Ti, int ticks);
+		//ticks from Ti to the next queued phase change, 1 if one
+		//is due now
+		int ticks_to_next_event(int Ti);
+        	template<int DIVISION> void perform_budding(int Ti);
 		void perform_mitosis(int Ti);
 		//void match_up();
-		void update_locations();
+		template<int BUDDING> void update_locations(double step_dt);
 		//shared_ptr<Cell> return_cell(int cell_rank);
-		void update_growth_rates();
-		void update_protein_concentration();
+		void update_growth_rates(double step_dt);
+		void advance_time(double step_dt);
+		void update_protein(int cell);
+		double get_protein(int cell);
         	//void print_vtk_file(ofstream& ofs);
-        	void write_data(ofstream& ofs);
+        	//copies the colony at tick Ti into frame, rows in rank order
+        	void take_snapshot(Snapshot& frame, int Ti);
+		//everything the colony, its mesh and its cells need to carry
+		//on, load goes into a colony made with the same seed
+		void save(Checkpoint_Out& out);
+		void load(Checkpoint_In& in);
 };
 
 //*********************************************
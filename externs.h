@@ -3,6 +3,7 @@
 //Include guards
 #ifndef _EXTERNS_H_INCLUDED_
 #define _EXTERNS_H_INCLUDED_
+#include <string>
 //Declares external nonconstant global variables that will be
 ////defined in main.h
 extern int Budding_On;
@@ -15,4 +16,11 @@ extern double K_MASS;
 extern double NUTRIENT_DECAY;
 extern int Nutrient_On;
 extern int Start_from_four;
+extern double VERLET_SKIN;
+extern double DT_TOLERANCE;
+extern int BIO_SUBSTEPS;
+extern int REORDER_INTERVAL;
+extern double SLEEP_SPEED;
+extern int SLEEP_STEPS;
+extern std::string FORCE_KERNEL;
 #endif
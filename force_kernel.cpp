@@ -0,0 +1,132 @@
+//force_kernel.cpp
+
+//******************************************
+//Include Dependencies
+#include <math.h>
+#include <immintrin.h>
+#include "parameters.h"
+#include "externs.h"
+#include "force_kernel.h"
+using namespace std;
+//******************************************
+//All three versions do the same operations in the same order
+//and the makefile builds this file without floating point
+//contraction, so they give bitwise identical forces. Repulsion
+//goes as overlap*sqrt(overlap) rather than pow(overlap,1.5) in
+//every version, which can differ from pow in the last bit.
+
+//effective elastic modulus for two cells of the same material
+static const double E_ij_inverse = 1/((3.0/4.0)*(2*(1-POISSON*POISSON)/ELASTIC_MOD));
+
+static double adhesion_coefficient(){
+	return SINGLE_BOND_BIND_ENERGY*RECEPTOR_SURF_DENSITY*KB*TEMPERATURE*M_PI*.5;
+}
+static void hertz_forces_scalar(double x, double y, double radius, const double* neighbor_x, const double* neighbor_y, const double* neighbor_radius, int num_neighbors, double* force_x, double* force_y){
+	double adhesion = adhesion_coefficient();
+	for(int k = 0; k < num_neighbors; k++){
+		double v_x = x - neighbor_x[k];
+		double v_y = y - neighbor_y[k];
+		double d_ij = sqrt(v_x*v_x + v_y*v_y);
+		double radius_sum = radius + neighbor_radius[k];
+		double overlap = radius_sum - d_ij;
+		double rep = 0;
+		if(overlap >= 0){
+			double sqrt_term = sqrt((radius*neighbor_radius[k])/radius_sum);
+			rep = (.5/d_ij)*(overlap*sqrt(overlap))*E_ij_inverse*sqrt_term;
+		}
+		double adh = 0;
+		if((overlap < ADH_RANGE) && (overlap > -ADH_RANGE)){
+			adh = -adhesion*radius_sum;
+		}
+		double scale = rep + adh;
+		force_x[k] = v_x*scale;
+		force_y[k] = v_y*scale;
+	}
+	return;
+}
+__attribute__((target("avx2")))
+static void hertz_forces_avx2(double x, double y, double radius, const double* neighbor_x, const double* neighbor_y, const double* neighbor_radius, int num_neighbors, double* force_x, double* force_y){
+	const __m256d my_x = _mm256_set1_pd(x);
+	const __m256d my_y = _mm256_set1_pd(y);
+	const __m256d my_radius = _mm256_set1_pd(radius);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d half = _mm256_set1_pd(.5);
+	const __m256d E_inv = _mm256_set1_pd(E_ij_inverse);
+	const __m256d range = _mm256_set1_pd(ADH_RANGE);
+	const __m256d minus_range = _mm256_set1_pd(-ADH_RANGE);
+	const __m256d minus_adhesion = _mm256_set1_pd(-adhesion_coefficient());
+	int k = 0;
+	for(; k + 4 <= num_neighbors; k += 4){
+		__m256d v_x = _mm256_sub_pd(my_x,_mm256_loadu_pd(neighbor_x+k));
+		__m256d v_y = _mm256_sub_pd(my_y,_mm256_loadu_pd(neighbor_y+k));
+		__m256d other_radius = _mm256_loadu_pd(neighbor_radius+k);
+		__m256d d_ij = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(v_x,v_x),_mm256_mul_pd(v_y,v_y)));
+		__m256d radius_sum = _mm256_add_pd(my_radius,other_radius);
+		__m256d overlap = _mm256_sub_pd(radius_sum,d_ij);
+		//lanes that do not overlap may hold nan here, the blend drops them
+		__m256d sqrt_term = _mm256_sqrt_pd(_mm256_div_pd(_mm256_mul_pd(my_radius,other_radius),radius_sum));
+		__m256d rep = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_div_pd(half,d_ij),_mm256_mul_pd(overlap,_mm256_sqrt_pd(overlap))),E_inv),sqrt_term);
+		rep = _mm256_blendv_pd(zero,rep,_mm256_cmp_pd(overlap,zero,_CMP_GE_OQ));
+		__m256d in_range = _mm256_and_pd(_mm256_cmp_pd(overlap,range,_CMP_LT_OQ),_mm256_cmp_pd(overlap,minus_range,_CMP_GT_OQ));
+		__m256d adh = _mm256_blendv_pd(zero,_mm256_mul_pd(minus_adhesion,radius_sum),in_range);
+		__m256d scale = _mm256_add_pd(rep,adh);
+		_mm256_storeu_pd(force_x+k,_mm256_mul_pd(v_x,scale));
+		_mm256_storeu_pd(force_y+k,_mm256_mul_pd(v_y,scale));
+	}
+	hertz_forces_scalar(x,y,radius,neighbor_x+k,neighbor_y+k,neighbor_radius+k,num_neighbors-k,force_x+k,force_y+k);
+	return;
+}
+__attribute__((target("avx512f")))
+static void hertz_forces_avx512(double x, double y, double radius, const double* neighbor_x, const double* neighbor_y, const double* neighbor_radius, int num_neighbors, double* force_x, double* force_y){
+	const __m512d my_x = _mm512_set1_pd(x);
+	const __m512d my_y = _mm512_set1_pd(y);
+	const __m512d my_radius = _mm512_set1_pd(radius);
+	const __m512d zero = _mm512_setzero_pd();
+	const __m512d half = _mm512_set1_pd(.5);
+	const __m512d E_inv = _mm512_set1_pd(E_ij_inverse);
+	const __m512d range = _mm512_set1_pd(ADH_RANGE);
+	const __m512d minus_range = _mm512_set1_pd(-ADH_RANGE);
+	const __m512d minus_adhesion = _mm512_set1_pd(-adhesion_coefficient());
+	for(int k = 0; k < num_neighbors; k += 8){
+		//the last block masks off lanes past the end
+		int lanes = num_neighbors - k;
+		__mmask8 active = (lanes >= 8) ? 0xFF : (__mmask8)((1 << lanes) - 1);
+		__m512d v_x = _mm512_sub_pd(my_x,_mm512_maskz_loadu_pd(active,neighbor_x+k));
+		__m512d v_y = _mm512_sub_pd(my_y,_mm512_maskz_loadu_pd(active,neighbor_y+k));
+		__m512d other_radius = _mm512_maskz_loadu_pd(active,neighbor_radius+k);
+		__m512d d_ij = _mm512_maskz_sqrt_pd(active,_mm512_add_pd(_mm512_mul_pd(v_x,v_x),_mm512_mul_pd(v_y,v_y)));
+		__m512d radius_sum = _mm512_add_pd(my_radius,other_radius);
+		__m512d overlap = _mm512_sub_pd(radius_sum,d_ij);
+		__mmask8 touching = _mm512_cmp_pd_mask(overlap,zero,_CMP_GE_OQ) & active;
+		__m512d sqrt_term = _mm512_maskz_sqrt_pd(touching,_mm512_maskz_div_pd(touching,_mm512_mul_pd(my_radius,other_radius),radius_sum));
+		__m512d rep = _mm512_maskz_mul_pd(touching,_mm512_mul_pd(_mm512_mul_pd(_mm512_maskz_div_pd(touching,half,d_ij),_mm512_mul_pd(overlap,_mm512_maskz_sqrt_pd(touching,overlap))),E_inv),sqrt_term);
+		__mmask8 in_range = _mm512_cmp_pd_mask(overlap,range,_CMP_LT_OQ) & _mm512_cmp_pd_mask(overlap,minus_range,_CMP_GT_OQ);
+		__m512d adh = _mm512_maskz_mul_pd(in_range,minus_adhesion,radius_sum);
+		__m512d scale = _mm512_add_pd(rep,adh);
+		_mm512_mask_storeu_pd(force_x+k,active,_mm512_mul_pd(v_x,scale));
+		_mm512_mask_storeu_pd(force_y+k,active,_mm512_mul_pd(v_y,scale));
+	}
+	return;
+}
+Hertz_Kernel select_hertz_kernel(){
+	__builtin_cpu_init();
+	bool any = (FORCE_KERNEL == "auto");
+	if((any || (FORCE_KERNEL == "avx512")) && __builtin_cpu_supports("avx512f")){
+		return hertz_forces_avx512;
+	}
+	if((any || (FORCE_KERNEL == "avx2")) && __builtin_cpu_supports("avx2")){
+		return hertz_forces_avx2;
+	}
+	if(any || (FORCE_KERNEL == "scalar")){
+		return hertz_forces_scalar;
+	}
+	return NULL;
+}
+const char* hertz_kernel_name(Hertz_Kernel kernel){
+	if(kernel == hertz_forces_avx512){
+		return "avx512";
+	}else if(kernel == hertz_forces_avx2){
+		return "avx2";
+	}
+	return "scalar";
+}
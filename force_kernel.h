@@ -0,0 +1,33 @@
+//force_kernel.h
+
+//*********************************************************
+// Include Guards
+#ifndef _FORCE_KERNEL_H_INCLUDED_
+#define _FORCE_KERNEL_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+
+//*********************************************************
+// include dependencies
+#include "parameters.h"
+#include "externs.h"
+//*********************************************************
+//Hertz contact force between one cell and a block of neighbors.
+//Lane k of force_x/force_y gets the force on the cell from
+//neighbor k, the neighbor feels the opposite. Each lane sums
+//  Hertz repulsion while the cells overlap
+//  adhesion while the cells are within ADH_RANGE of touching
+//mother-bud springs are bonded forces, see Colony::compute_bond_forces
+typedef void (*Hertz_Kernel)(double x, double y, double radius, const double* neighbor_x, const double* neighbor_y, const double* neighbor_radius, int num_neighbors, double* force_x, double* force_y);
+
+//picks the widest SIMD version the cpu running the
+//simulation supports, scalar if none, or the one named by
+//FORCE_KERNEL. NULL if that one is unknown or not supported
+Hertz_Kernel select_hertz_kernel();
+const char* hertz_kernel_name(Hertz_Kernel kernel);
+
+//End force kernels
+//**************************************************************
+#endif
+
@@ -12,12 +12,17 @@
 #include <memory>
 #include <random>
 #include <stdio.h>
+#include <omp.h>
+#include <signal.h>
 #include "colony.h"
 #include "parameters.h"
 #include "coord.h"
 #include "cell.h"
 #include "mesh.h"
 #include "mesh_pt.h"
+#include "snapshot.h"
+#include "checkpoint.h"
+#include "output_sink.h"
 //****************************************
 
 using namespace std;
@@ -40,10 +45,201 @@ double A_LOGISTIC = 35;
 //governing nutrient concentration in each bucket
 double K_MASS = 18*M_PI*pow(3.1,2);
 double NUTRIENT_DECAY = .003;
+//extra distance (microns) beyond interaction range kept in
+//neighbor lists, lists are rebuilt once cells move half of it
+double VERLET_SKIN = 1.0;
+//adaptive time stepping is off at 0, otherwise the largest
+//distance (microns) a cell may move or grow in one step
+double DT_TOLERANCE = 0;
+//mechanics steps per biology step, cell cycle, nutrient and
+//protein advance once over all of them, growth with each
+int BIO_SUBSTEPS = 1;
+//cell storage is sorted along a space filling curve every this
+//many neighbor list builds, 0 keeps cells in birth order
+int REORDER_INTERVAL = 0;
+//cells slower than this (microns/min) for SLEEP_STEPS mechanics
+//steps in a row stop moving until something near them moves,
+//0 turns sleeping off
+double SLEEP_SPEED = 0;
+int SLEEP_STEPS = 10;
+//contact force kernel, auto picks the widest the cpu supports,
+//scalar, avx2 or avx512 force one to compare them
+string FORCE_KERNEL = "auto";
+//a checkpoint is written every this many dt ticks, 0 for none
+int CHECKPOINT_EVERY = 0;
+//set by SIGTERM or SIGUSR1, the run checkpoints and stops
+volatile sig_atomic_t stop_signal = 0;
+//*****************************************
+//one biology step followed by substeps mechanics steps of
+//ticks*dt each, specialized on the model switches so the loops
+//inside carry no tests of Budding_On, Division_Pattern or
+//Nutrient_On
+template<int BUDDING, int DIVISION, int NUTRIENT>
+void time_step(Colony& growing_Colony, int Ti, int ticks, int substeps){
+	double step_dt = ticks*dt;
+	double bio_dt = ticks*substeps*dt;
+	//rebin and rebuild neighbor lists for computing
+	//forces once cells have moved far enough
+	growing_Colony.update_neighbor_lists();
+	//cout << "bins" << endl;
+	if(NUTRIENT){
+		growing_Colony.update_growth_rates(bio_dt);
+		//growth rate changes according to nutrient conc in bin
+	}
+	
+        //growth, a mechanics step at a time so no step grows a cell
+        //more than choose_time_step allowed for
+        //cout << "grow" << endl;
+	growing_Colony.grow_cells(step_dt);
+		
+	//cell cyle
+	//cout << "cell cycle" << endl;
+        growing_Colony.update_cell_cycles(Ti,ticks*substeps);
+
+    	//budding
+        //cout<< "budding" << endl;
+	growing_Colony.perform_budding<DIVISION>(Ti);
+
+	//remove buds that are big enough
+        //cout << "mitosis" << endl;
+	growing_Colony.perform_mitosis(Ti);
+		
+	//pulling test for mother-bud adhesion
+	//growing_Colony.pull_daughter();
+
+	//spatial rearrangment
+	//cout << "rearrange" << endl;
+	growing_Colony.update_locations<BUDDING>(step_dt);
+	for(int s = 1; s < substeps; s++){
+		growing_Colony.update_neighbor_lists();
+		growing_Colony.grow_cells(step_dt);
+		growing_Colony.update_locations<BUDDING>(step_dt);
+	}
+	//cout << "rearranged" << endl;
+       
+        //protein is brought up to date only when it is read
+        //cout << "Protein Conc" << endl;
+        growing_Colony.advance_time(bio_dt);
+	//cout << "protein end" << endl;
+	return;
+}
+typedef void (*Time_Step)(Colony& growing_Colony, int Ti, int ticks, int substeps);
+void request_stop(int signum){
+	stop_signal = signum;
+	return;
+}
+//main's loop state goes first, then the colony
+//flags that change the state a checkpoint holds or how it moves
+//on, a restart must be given the same values
+vector<pair<string,double>> run_parameters(){
+	vector<pair<string,double>> parameters;
+	parameters.push_back(make_pair("-Budding",Budding_On));
+	parameters.push_back(make_pair("-HERTZ_ADH",SINGLE_BOND_BIND_ENERGY));
+	parameters.push_back(make_pair("-Initial_Protein",P_0));
+	parameters.push_back(make_pair("-growth_rate",r_LOGISTIC));
+	parameters.push_back(make_pair("-competition_term",A_LOGISTIC));
+	parameters.push_back(make_pair("-division",Division_Pattern));
+	parameters.push_back(make_pair("-nutrient_mass",K_MASS));
+	parameters.push_back(make_pair("-nutrient_decay",NUTRIENT_DECAY));
+	parameters.push_back(make_pair("-nutrient_depletion",Nutrient_On));
+	parameters.push_back(make_pair("-start_from_four",Start_from_four));
+	parameters.push_back(make_pair("-verlet_skin",VERLET_SKIN));
+	parameters.push_back(make_pair("-adaptive_dt",DT_TOLERANCE));
+	parameters.push_back(make_pair("-bio_substeps",BIO_SUBSTEPS));
+	parameters.push_back(make_pair("-reorder_interval",REORDER_INTERVAL));
+	parameters.push_back(make_pair("-sleep_speed",SLEEP_SPEED));
+	parameters.push_back(make_pair("-sleep_steps",SLEEP_STEPS));
+	return parameters;
+}
+bool write_checkpoint(const string& filename, Colony& growing_Colony, uint64_t seed, int Ti, int ticks, int out){
+	Checkpoint_Out checkpoint(filename);
+	vector<pair<string,double>> parameters = run_parameters();
+	checkpoint.put((uint32_t)parameters.size());
+	for(unsigned int i = 0; i < parameters.size(); i++){
+		checkpoint.put(parameters[i].second);
+	}
+	string kernel = growing_Colony.get_force_kernel_name();
+	checkpoint.put_vector(vector<char>(kernel.begin(),kernel.end()));
+	checkpoint.put(seed);
+	checkpoint.put((int32_t)Ti);
+	checkpoint.put((int32_t)ticks);
+	checkpoint.put((int32_t)out);
+	growing_Colony.save(checkpoint);
+	return checkpoint.close();
+}
+//false, after saying which, if the checkpoint was written with
+//other parameters than this run has
+bool check_run_parameters(Checkpoint_In& checkpoint){
+	vector<pair<string,double>> parameters = run_parameters();
+	uint32_t count = checkpoint.get_uint();
+	if(count != parameters.size()){
+		cout << "checkpoint holds " << count << " run parameters, this program has " << parameters.size() << endl;
+		return false;
+	}
+	bool same = true;
+	for(unsigned int i = 0; i < parameters.size(); i++){
+		double saved = checkpoint.get_double();
+		if(saved != parameters[i].second){
+			cout << "checkpoint was written with " << parameters[i].first << " " << saved << ", this run has " << parameters[i].second << endl;
+			same = false;
+		}
+	}
+	return same;
+}
+//the kernels only agree to roundoff, so a restart on a cpu that
+//picks another one carries on, but not bit for bit
+void check_force_kernel(Checkpoint_In& checkpoint){
+	vector<char> saved;
+	checkpoint.get_vector(saved);
+	string kernel(saved.begin(),saved.end());
+	string current = hertz_kernel_name(select_hertz_kernel());
+	if(checkpoint.good() && (kernel != current)){
+		cout << "warning: checkpoint was written with the " << kernel << " force kernel, this run uses " << current << ", give -force_kernel " << kernel << " to match it" << endl;
+	}
+	return;
+}
+template<int BUDDING, int DIVISION>
+Time_Step select_time_step(){
+	if(Nutrient_On){
+		return time_step<BUDDING,DIVISION,1>;
+	}
+	return time_step<BUDDING,DIVISION,0>;
+}
+template<int BUDDING>
+Time_Step select_time_step(){
+	if(Division_Pattern == 0){
+		return select_time_step<BUDDING,0>();
+	}else if(Division_Pattern == 1){
+		return select_time_step<BUDDING,1>();
+	}else if(Division_Pattern == 2){
+		return select_time_step<BUDDING,2>();
+	}
+	return NULL;
+}
+Time_Step select_time_step(){
+	if(Budding_On == 1){
+		return select_time_step<1>();
+	}
+	return select_time_step<0>();
+}
 int main(int argc, char* argv[]) {
     //cout << "Starting" << endl;
     //reads in name of folder to store output for visualization
     string anim_folder = argv[1];
+    //a run is reproduced by passing the seed it reports
+    uint64_t seed = random_device()();
+    //frames are text files unless -output_format binary (a
+    //snapshot file per frame) or series (one delta coded file),
+    //see snapshot.h and series.h
+    string output_format = "text";
+    //binary frames are float32 unless this is "double"
+    string snapshot_precision = "single";
+    //frames go to files unless -output_sink streams them to a
+    //consumer, see output_sink.h
+    string output_sink = "file";
+    //checkpoint to carry on from, the other arguments must match
+    //the run that wrote it
+    string restart_file;
     for(int i = 1; i < argc; i++){
     	if(!strcmp(argv[i], "-Budding")){
 		Budding_On = stod(argv[i+1]);
@@ -65,53 +261,163 @@ int main(int argc, char* argv[]) {
 		Nutrient_On = stod(argv[i+1]);
 	}else if(!strcmp(argv[i],"-start_from_four")){
 		Start_from_four = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-verlet_skin")){
+		VERLET_SKIN = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-seed")){
+		seed = stoull(argv[i+1]);
+	}else if(!strcmp(argv[i],"-adaptive_dt")){
+		DT_TOLERANCE = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-bio_substeps")){
+		BIO_SUBSTEPS = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-reorder_interval")){
+		REORDER_INTERVAL = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-sleep_speed")){
+		SLEEP_SPEED = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-sleep_steps")){
+		SLEEP_STEPS = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-force_kernel")){
+		FORCE_KERNEL = argv[i+1];
+	}else if(!strcmp(argv[i],"-output_format")){
+		output_format = argv[i+1];
+	}else if(!strcmp(argv[i],"-snapshot_precision")){
+		snapshot_precision = argv[i+1];
+	}else if(!strcmp(argv[i],"-output_sink")){
+		output_sink = argv[i+1];
+	}else if(!strcmp(argv[i],"-checkpoint_every")){
+		CHECKPOINT_EVERY = stod(argv[i+1]);
+	}else if(!strcmp(argv[i],"-restart")){
+		restart_file = argv[i+1];
+	}
+    }
+    Output_Format format;
+    if(output_format == "text"){
+	format = TEXT_OUTPUT;
+    }else if(output_format == "binary"){
+	format = SNAPSHOT_OUTPUT;
+    }else if(output_format == "series"){
+	format = SERIES_OUTPUT;
+    }else{
+	cout << "unknown output format " << output_format << endl;
+	return 1;
+    }
+    if((snapshot_precision != "single") && (snapshot_precision != "double")){
+	cout << "unknown snapshot precision " << snapshot_precision << endl;
+	return 1;
+    }
+    if((format == SERIES_OUTPUT) && (output_sink != "file")){
+	cout << "series output can only go to a file" << endl;
+	return 1;
+    }
+    //the sink is opened before anything is printed, streaming
+    //to stdout moves the log to stderr
+    string initial = "/locations";
+    unique_ptr<Output_Sink> sink;
+    if(format != SERIES_OUTPUT){
+	sink = open_output_sink(output_sink,anim_folder + initial,format == SNAPSHOT_OUTPUT ? ".snap" : ".txt",format == SNAPSHOT_OUTPUT);
+	if(!sink){
+		cout << "could not open output " << output_sink << endl;
+		return 1;
 	}
     }
+    //one level of parallelism: every parallel loop is a single
+    //team over cells, bins or pairs and never opens another team
+    omp_set_max_active_levels(1);
+    int num_threads = omp_get_max_threads();
+    int num_procs = omp_get_num_procs();
+    cout << "OpenMP threads: " << num_threads << " on " << num_procs << " processors" << endl;
+    if(num_threads > num_procs){
+	cout << "warning: more threads than processors, set OMP_NUM_THREADS to the cores requested" << endl;
+    }
+    if((num_threads > 1) && (omp_get_proc_bind() == omp_proc_bind_false)){
+	cout << "warning: threads are not pinned, set OMP_PROC_BIND=close and OMP_PLACES=cores" << endl;
+    }
+    //pick the time step for this combination of switches
+    Time_Step step = select_time_step();
+    if(step == NULL){
+	cout << "unknown division pattern " << Division_Pattern << endl;
+	return 1;
+    }
+    if(select_hertz_kernel() == NULL){
+	cout << "force kernel " << FORCE_KERNEL << " is unknown or not supported by this cpu" << endl;
+	return 1;
+    }
     //keeps track of simulation time
     int start = clock();
     //cout << "clock" << endl;
     string init_colony = "mixed_initial.csv";
     //cout << "read in colony text file" << endl;
     
-    //initialize seed for generating random numbers
-    //is fed to colony constructor so that colony holds
-    //the same seed and can give to other classes
-    std::random_device seed;
-    std::mt19937 gen(seed());
+    //a restart picks up the seed and loop state of the run
+    //that wrote the checkpoint
+    unique_ptr<Checkpoint_In> restart;
+    int start_tick = 0;
+    int start_ticks = 1;
+    int start_out = 1;
+    if(!restart_file.empty()){
+	restart.reset(new Checkpoint_In(restart_file));
+	if(restart->good() && !check_run_parameters(*restart)){
+		cout << "restart with the flags of the run that wrote " << restart_file << endl;
+		return 1;
+	}
+	check_force_kernel(*restart);
+	seed = restart->get_uint64();
+	start_tick = restart->get_int();
+	start_ticks = restart->get_int();
+	start_out = restart->get_int();
+	if(!restart->good()){
+		cout << "could not read checkpoint " << restart_file << endl;
+		return 1;
+	}
+	cout << "Restarting from tick " << start_tick << endl;
+    }
+    //the colony and every cell draw from counter based streams
+    //keyed by this seed, see philox.h
+    cout << "Seed: " << seed << endl;
     //make mesh for bucketing
     //cout << "make mesh" << endl;
-    auto mesh_for_bins = make_shared<Mesh>();
-    //leftmost point for mesh
+    //bins are made as the colony reaches them, start_1 and start_2
+    //only anchor the grid so bin edges stay where they always were
     int start_1 = -400;
-    //rightmost point for mesh
     int start_2 = 400;
     //each square unit on mesh will be this many units
     double increment = 25.0;
-    int num_buckets = 2*ceil(start_2/increment);
-    //cout << " make bins " << endl;
-    mesh_for_bins->make_mesh_pts(start_1,start_2,num_buckets,increment);
-    //cout << "make neighbors" << endl;
-    mesh_for_bins->assign_neighbors();
+    //neighbor lists are built from a bin and its neighbors
+    //so bins must be at least one interaction range wide, and
+    //a bud, listed from its mother's bin when it is born, can be
+    //another half skin away from where the bin was found
+    if(2*1.1*average_radius + ADH_RANGE + 1.5*VERLET_SKIN > increment){
+	cout << "verlet skin too large for mesh increment" << endl;
+	return 1;
+    }
+    auto mesh_for_bins = make_shared<Mesh>(start_1,start_2,increment);
     
     //make colony object
-    //gen is the seed for random numbers
-    auto growing_Colony = make_shared<Colony>(mesh_for_bins,gen);
+    auto growing_Colony = make_shared<Colony>(mesh_for_bins,seed);
+    cout << "Force kernel: " << growing_Colony->get_force_kernel_name() << (FORCE_KERNEL == "auto" ? "" : " (forced)") << endl;
     //cout << "Made Colony" << endl;
     
     //make founder cell
     //growing_Colony->make_founder_cell(init_colony);
     //growing_Colony->match_up();
     //cout << "Match up" << endl;
-    growing_Colony->make_founder_cell();
+    if(restart){
+	growing_Colony->load(*restart);
+	if(!restart->good()){
+		cout << "could not read checkpoint " << restart_file << endl;
+		return 1;
+	}
+	restart.reset();
+    }else{
+	growing_Colony->make_founder_cell();
+    }
     //cout << "Made Founder Cell" << endl;
     
-    //variables for writing output files
-    string format = ".txt";
-    string initial = "/locations";
-    int out = 1;
-    ofstream myfile;
-    string Number;
-    string Filename;
+    //variables for writing output files, frames are copied
+    //out of the colony and written by a background thread,
+    //a restarted series drops what it wrote after the checkpoint
+    Snapshot_Writer writer(format,snapshot_precision == "double",move(sink),anim_folder + initial,start_tick);
+    int out = start_out;
+    unique_ptr<Snapshot> frame;
 
     //not in use********************************
     //some variables for writing vtk files
@@ -125,61 +431,52 @@ int main(int argc, char* argv[]) {
    //*****************************************
    
    //loop for time steps
-   for (int Ti = 0; Ti < NUM_STEPS; Ti++) {
+   //Ti counts dt ticks, an adaptive step covers several and a
+   //biology step covers ticks*substeps
+   int ticks = start_ticks;
+   int substeps = 1;
+   //checkpoints go next to the frames, a scheduler about to end
+   //the job sends SIGTERM (or SIGUSR1 with --signal) first
+   string checkpoint_file = anim_folder + "/checkpoint.bin";
+   int next_checkpoint = CHECKPOINT_EVERY > 0 ? (start_tick/CHECKPOINT_EVERY + 1)*CHECKPOINT_EVERY : NUM_STEPS;
+   signal(SIGTERM,request_stop);
+   signal(SIGUSR1,request_stop);
+   for (int Ti = start_tick; Ti < NUM_STEPS; Ti += ticks*substeps) {
+	//checkpoints are taken before the frame so a restart
+	//writes the same frame at the same tick
+	if(stop_signal || (Ti >= next_checkpoint)){
+		if(!write_checkpoint(checkpoint_file,*growing_Colony,seed,Ti,ticks,out)){
+			cout << "could not write checkpoint " << checkpoint_file << endl;
+		}
+		if(stop_signal){
+			writer.finish();
+			cout << "Stopped by signal " << stop_signal << " at tick " << Ti << ", restart with -restart " << checkpoint_file << endl;
+			return 2;
+		}
+		next_checkpoint = (Ti/CHECKPOINT_EVERY + 1)*CHECKPOINT_EVERY;
+	}
   	//write data to txt file
 	//change OUTPUT_FREQ to smaller number in parameters.h
 	//if want to see more timesteps 
 	//cout << "In time loop" << endl;
 	if(Ti%OUTPUT_FREQ == 0){
-        	//open txt file for writing cell data
-            	Number = to_string(out);
-           	Filename = anim_folder + initial + Number + format;
-            	myfile.open(Filename.c_str());
-            	growing_Colony->write_data(myfile);
-            	myfile.close();
+        	//hand a copy of the cell data to the writer
+            	frame = writer.get_buffer();
+            	growing_Colony->take_snapshot(*frame,Ti);
+            	writer.submit(move(frame),out);
             	out++;
         } 
         //cout << "Time: " << Ti << endl;
-        
-	//assign each cell to closest bin
-	//for computing forces
-	if(Ti%1000 == 0){
-		growing_Colony->find_bin();
-		//cout << "bins" << endl;
-	}
-	if(Nutrient_On){
-		growing_Colony->update_growth_rates();
-		//growth rate changes according to nutrient conc in bin
+	//never step past the next output frame
+	int max_ticks = min(OUTPUT_FREQ - Ti%OUTPUT_FREQ,NUM_STEPS - Ti);
+	if(DT_TOLERANCE > 0){
+		ticks = growing_Colony->choose_time_step(ticks,max_ticks);
 	}
-	
-        //growth
-        //cout << "grow" << endl;
-	growing_Colony->grow_cells();
-		
-	//cell cyle
-	//cout << "cell cycle" << endl;
-        growing_Colony->update_cell_cycles(Ti);
-
-    	//budding
-        //cout<< "budding" << endl;
-	growing_Colony->perform_budding(Ti);
-
-	//remove buds that are big enough
-        //cout << "mitosis" << endl;
-	growing_Colony->perform_mitosis(Ti);
-		
-	//pulling test for mother-bud adhesion
-	//growing_Colony->pull_daughter();
-
-	//spatial rearrangment
-	//cout << "rearrange" << endl;
-	growing_Colony->update_locations();
-	//cout << "rearranged" << endl;
-       
-        //compute protein concentration
-        //cout << "Protein Conc" << endl;
-        growing_Colony->update_protein_concentration();
-	//cout << "protein end" << endl;
+	//nor past the next phase change, which has to be tested on
+	//its own tick
+	int bio_ticks = min(max_ticks,growing_Colony->ticks_to_next_event(Ti));
+	substeps = max(1,min(BIO_SUBSTEPS,bio_ticks/ticks));
+	step(*growing_Colony,Ti,ticks,substeps);
       	//not in use********************************
 	//make vtk files
 	/*if(Ti%100 == 0){digits = ceil(log10(out +1));
@@ -203,15 +500,21 @@ int main(int argc, char* argv[]) {
 		out++;
 	}*/
      }
-     //open txt file for writing cell data
-     Number = to_string(out);
-     Filename = anim_folder + initial + Number + format;
-     myfile.open(Filename.c_str());
-     growing_Colony->write_data(myfile);
-     myfile.close();
+     //last frame, then wait for every frame to be written
+     frame = writer.get_buffer();
+     growing_Colony->take_snapshot(*frame,NUM_STEPS);
+     writer.submit(move(frame),out);
+     writer.finish();
   
      int stop = clock();
      cout << "Time: " << (stop-start) / double(CLOCKS_PER_SEC)*1000 << endl;
+     //a finished run must not be picked up again from its last
+     //checkpoint, the batch scripts look for checkpoint.done
+     ifstream last_checkpoint(checkpoint_file.c_str());
+     if(last_checkpoint){
+	last_checkpoint.close();
+	rename(checkpoint_file.c_str(),(anim_folder + "/checkpoint.done").c_str());
+     }
      //Need to add way to store data over multiple runs
     
     return 0;
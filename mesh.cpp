@@ -10,91 +10,200 @@
 #include <ctime>
 #include <cstdio>
 #include <memory>
+#include <omp.h>
+#include <algorithm>
 #include "parameters.h"
 #include "coord.h"
 #include "cell.h"
 #include "colony.h"
 #include "mesh_pt.h"
 #include "mesh.h"
+#include "checkpoint.h"
 using namespace std;
 //****************************************
 //Public member functions for mesh.cpp
 
-//constructor
-Mesh::Mesh(){
-	
-	return;
+//bin keys pack the column in the high 32 bits and the row in the low
+static int64_t make_bin_key(int col, int row){
+	return ((int64_t)col << 32) | (uint32_t)row;
 }
-void Mesh::make_mesh_pts(double x_start, double y_start, int num_buckets, double increment){
-	shared_ptr<Mesh> this_mesh = shared_from_this();
-	double x_coord = x_start;
-	double y_coord = y_start;
-	int index = 1;
-	for (int i = 0;i < num_buckets+1 ;i++){
-		x_coord = x_start;
-		for(int j = 0; j<num_buckets+1; j++){	
-			auto new_mesh_pt= make_shared<Mesh_Pt>(this_mesh, x_coord, y_coord, index);
-			//should be paired vector
-			update_mesh_pts_vec(new_mesh_pt,index);
-			x_coord = x_coord + increment;
-			index++;
-		}
-		y_coord = y_coord - increment;
-	}
-	//cout << "How many mesh points made?" << mesh_pts.size() << endl;
-	for(unsigned int i = 0; i< mesh_pts.size(); i++){
-		//cout << "index: " << mesh_pts.at(i).second << endl;
-		//cout << "center: " << mesh_pts.at(i).first->get_center() << endl;
+//stencil offsets: the bin, its edge neighbors, then the corners
+static const int STENCIL_COL[STENCIL_SIZE] = {0, 0,-1, 1, 0,-1, 1,-1, 1};
+static const int STENCIL_ROW[STENCIL_SIZE] = {0,-1, 0, 0, 1,-1,-1, 1, 1};
+//entry of the stencil that points back the other way
+static const int STENCIL_OPPOSITE[STENCIL_SIZE] = {0, 4, 3, 2, 1, 8, 7, 6, 5};
 
-	}
+//constructor
+Mesh::Mesh(double x_start, double y_start, double increment){
+	this->x_start = x_start;
+	this->y_start = y_start;
+	this->increment = increment;
 	return;
-
 }
-void Mesh::update_mesh_pts_vec(shared_ptr<Mesh_Pt>& new_mesh_pt, int index){
-	mesh_pts.push_back(make_pair(new_mesh_pt,index));
+void Mesh::update_mesh_pts_vec(unique_ptr<Mesh_Pt> new_mesh_pt, int index){
+	mesh_pts.push_back(make_pair(move(new_mesh_pt),index));
 	return;
 }
-void Mesh::get_mesh_pts_vec(vector<shared_ptr<Mesh_Pt>>& new_mesh_pts){
+void Mesh::get_mesh_pts_vec(vector<Mesh_Pt*>& new_mesh_pts){
 	for(unsigned int i = 0; i < mesh_pts.size(); i++){
-		new_mesh_pts.push_back(this->mesh_pts.at(i).first);
+		new_mesh_pts.push_back(this->mesh_pts.at(i).first.get());
 	}
 	return;
 }
-void Mesh::assign_neighbors(){
-	for(unsigned int i = 0; i<mesh_pts.size();i++){
-		//cout << "Mesh Pt " << i << "neighbors" << endl;
-		mesh_pts.at(i).first->find_neighbor_bins();
+int64_t Mesh::get_bin_key(const Coord& loc) const{
+	//nearest bin center is the nearest row and column
+	int col = (int)floor((loc.get_X() - x_start)/increment + .5);
+	int row = (int)floor((y_start - loc.get_Y())/increment + .5);
+	return make_bin_key(col,row);
+}
+int Mesh::get_bin_index(int64_t key){
+	auto found = bin_lookup.find(key);
+	if(found != bin_lookup.end()){
+		return found->second;
 	}
-
-	return;
+	int col = (int)(key >> 32);
+	int row = (int)(uint32_t)key;
+	int index = mesh_pts.size();
+	unique_ptr<Mesh_Pt> new_mesh_pt(new Mesh_Pt(this, x_start + col*increment, y_start - row*increment, index));
+	update_mesh_pts_vec(move(new_mesh_pt),index);
+	bin_lookup[key] = index;
+	bin_keys.push_back(key);
+	//link the new bin with whichever neighbors exist already
+	stencil.resize(mesh_pts.size()*STENCIL_SIZE,-1);
+	stencil[index*STENCIL_SIZE] = index;
+	for(int k = 1; k < STENCIL_SIZE; k++){
+		auto neighbor = bin_lookup.find(make_bin_key(col + STENCIL_COL[k],row + STENCIL_ROW[k]));
+		if(neighbor != bin_lookup.end()){
+			stencil[index*STENCIL_SIZE + k] = neighbor->second;
+			stencil[neighbor->second*STENCIL_SIZE + STENCIL_OPPOSITE[k]] = index;
+		}
+	}
+	return index;
 }
-
-void Mesh::assign_cell_to_bin(int& index, shared_ptr<Cell>& new_cell){
-	this->mesh_pts.at(index).first->add_cell(new_cell);
-	return;
+//spreads the bits of v out to the even bits of the result
+static uint64_t spread_bits(uint32_t v){
+	uint64_t x = v;
+	x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+	x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+	x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	x = (x | (x << 2)) & 0x3333333333333333ULL;
+	x = (x | (x << 1)) & 0x5555555555555555ULL;
+	return x;
+}
+uint64_t Mesh::get_morton_key(int64_t key){
+	//flipping the sign bit keeps negative rows and columns
+	//in order once they are read as unsigned
+	uint32_t col = (uint32_t)(key >> 32) ^ 0x80000000u;
+	uint32_t row = (uint32_t)key ^ 0x80000000u;
+	return (spread_bits(row) << 1) | spread_bits(col);
 }
-void Mesh::get_cells_from_bin(int& index, vector<shared_ptr<Cell>>& neighbors){
-	//cout << "i think its an index problem" << endl;
-	//cout << "num msh pts" << mesh_pts.size()<< endl;
-	//cout << "index cell from bin function " << index << endl;
-	//cout << "this bin" << endl;
-	vector<shared_ptr<Mesh_Pt>> neighbor_bins;
-	this->mesh_pts.at(index).first->get_cells(neighbors);
-	//cout << "neighbor bins" << endl;
-	this->mesh_pts.at(index).first->get_neighbor_bins(neighbor_bins);
-	for(unsigned int i = 0; i<neighbor_bins.size();i++){
-		neighbor_bins.at(i)->add_cells_to_neighbor_vec(neighbors);
+void Mesh::build_cell_list(const vector<int>& cell_bins, int num_cells){
+	//parallel counting sort of cell indices by bin id over the
+	//occupied bins only, bins that hold no cells cost nothing
+	//pass 1: each thread counts the bins of its block of cells
+	//pass 2: prefix sum gives each thread its own slots in every bin
+	//scatter uses the same contiguous blocks as pass 1 so cells keep
+	//their relative order inside each bin for any thread count
+	int num_bins = mesh_pts.size();
+	int max_threads = omp_get_max_threads();
+	thread_counts.resize(max_threads);
+	thread_bins.resize(max_threads);
+	for(int b : occupied_bins){
+		bin_size[b] = 0;
+	}
+	bin_start.resize(num_bins,0);
+	bin_size.resize(num_bins,0);
+	bin_cells.resize(num_cells);
+	#pragma omp parallel
+	{
+		int num_threads = omp_get_num_threads();
+		vector<int>& my_counts = thread_counts[omp_get_thread_num()];
+		vector<int>& my_bins = thread_bins[omp_get_thread_num()];
+		//bins made since the last build start out empty
+		my_counts.resize(num_bins,0);
+		my_bins.clear();
+		#pragma omp for schedule(static)
+		for(int i = 0; i < num_cells; i++){
+			int b = cell_bins[i];
+			if(my_counts[b]++ == 0){
+				my_bins.push_back(b);
+			}
+		}
+		#pragma omp single
+		{
+			occupied_bins.clear();
+			for(int k = 0; k < num_threads; k++){
+				occupied_bins.insert(occupied_bins.end(),thread_bins[k].begin(),thread_bins[k].end());
+			}
+			sort(occupied_bins.begin(),occupied_bins.end());
+			occupied_bins.erase(unique(occupied_bins.begin(),occupied_bins.end()),occupied_bins.end());
+		}
+		//turn per thread counts into offsets within each bin
+		int num_occupied = occupied_bins.size();
+		#pragma omp for schedule(static)
+		for(int k = 0; k < num_occupied; k++){
+			int b = occupied_bins[k];
+			int total = 0;
+			for(int u = 0; u < num_threads; u++){
+				int count = thread_counts[u][b];
+				thread_counts[u][b] = total;
+				total += count;
+			}
+			bin_size[b] = total;
+		}
+		#pragma omp single
+		{
+			int start = 0;
+			for(int b : occupied_bins){
+				bin_start[b] = start;
+				start += bin_size[b];
+			}
+		}
+		#pragma omp for schedule(static)
+		for(int i = 0; i < num_cells; i++){
+			int b = cell_bins[i];
+			bin_cells[bin_start[b] + my_counts[b]++] = i;
+		}
+		//leave the counts zero for the next build, the prefix sum
+		//wrote every thread's entry for each occupied bin
+		#pragma omp for schedule(static)
+		for(int k = 0; k < num_occupied; k++){
+			for(int u = 0; u < num_threads; u++){
+				thread_counts[u][occupied_bins[k]] = 0;
+			}
+		}
 	}
-	//cout << "but it could be somthing else" << endl;
-	//get neighbors
-	//push back cells from neighbors
 	return;
-
+}
+Cell_Span Mesh::get_cells_in_bin(int index) const{
+	Cell_Span span;
+	span.first = bin_cells.data() + bin_start[index];
+	span.last = span.first + bin_size[index];
+	return span;
 }
 double Mesh::get_nutrient_conc(int bin_id){
-	shared_ptr<Mesh_Pt> curr_mesh_pt = this->mesh_pts.at(bin_id).first;
-	double conc = curr_mesh_pt ->get_nutrient_conc();
+	double conc = this->mesh_pts[bin_id].first->get_nutrient_conc();
 	return conc;
 }
 	
 	
+void Mesh::save(Checkpoint_Out& out){
+	vector<double> concs(mesh_pts.size());
+	for(unsigned int i = 0; i < mesh_pts.size(); i++){
+		concs[i] = mesh_pts[i].first->get_nutrient_conc();
+	}
+	out.put_vector(bin_keys);
+	out.put_vector(concs);
+	return;
+}
+void Mesh::load(Checkpoint_In& in){
+	vector<int64_t> keys;
+	vector<double> concs;
+	in.get_vector(keys);
+	in.get_vector(concs);
+	for(unsigned int i = 0; (i < keys.size()) && (i < concs.size()); i++){
+		int index = get_bin_index(keys[i]);
+		mesh_pts[index].first->set_nutrient_conc(concs[i]);
+	}
+	return;
+}
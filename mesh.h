@@ -10,34 +10,84 @@
 
 //**************************************
 // include dependencies
-#include <boost/enable_shared_from_this.hpp>
-#include <boost/shared_ptr.hpp>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <iostream>
 #include <cstdio>
 #include <memory>
+#include <unordered_map>
+#include <stdint.h>
 #include "parameters.h"
 #include "coord.h"
 #include "mesh_pt.h"
+#include "checkpoint.h"
+//**************************************************
+//read-only view of a run of cell indices
+//(the cells of one bin or one neighbor list)
+struct Cell_Span {
+	const int* first;
+	const int* last;
+	const int* begin() const {return first;}
+	const int* end() const {return last;}
+};
+//a bin plus its 8 neighbors, -1 where a neighbor
+//has not been made yet
+const int STENCIL_SIZE = 9;
 //**************************************************
 //mesh struct declaration
 
-class Mesh: public enable_shared_from_this<Mesh>{
+//Sparse, unbounded grid of square bins. A bin and its Mesh_Pt
+//are made the first time a cell lands in it, so memory and the
+//per bin passes follow the colony and not a fixed domain.
+class Mesh {
 	private:
-		vector<pair<shared_ptr<Mesh_Pt>,int>> mesh_pts;
+		//the mesh is the only owner of its points, in the
+		//order the bins were made
+		vector<pair<unique_ptr<Mesh_Pt>,int>> mesh_pts;
+		//grid layout, bin centers are x_start + col*increment and
+		//y_start - row*increment for any integer row and col
+		double x_start;
+		double y_start;
+		double increment;
+		//bin index of each (col,row) key made so far, and back
+		unordered_map<int64_t,int> bin_lookup;
+		vector<int64_t> bin_keys;
+		//cell list: cells of bin i are bin_cells[bin_start[i]..bin_start[i]+bin_size[i]),
+		//only the bins in occupied_bins, in index order, hold any
+		vector<int> bin_start;
+		vector<int> bin_size;
+		vector<int> bin_cells;
+		vector<int> occupied_bins;
+		//per thread counts of the cell list build, by bin, kept
+		//zero between builds so a build only touches the bins that
+		//hold cells, and the bins each thread counted a cell in
+		vector<vector<int>> thread_counts;
+		vector<vector<int>> thread_bins;
+		//STENCIL_SIZE bin indices per bin, the bin itself first
+		vector<int> stencil;
 	public:
 		//constructor
-		Mesh();
-		void make_mesh_pts(double x_start, double y_start, int num_buckets, double increment);
-		void update_mesh_pts_vec(shared_ptr<Mesh_Pt>& new_mesh_pt, int index);
-		void get_mesh_pts_vec(vector<shared_ptr<Mesh_Pt>>& mesh_points);
-		void assign_neighbors();
-		void assign_cell_to_bin(int& index, shared_ptr<Cell>& new_cell);
-		void get_cells_from_bin(int& index, vector<shared_ptr<Cell>>& neighbors);
-		void calculate_nutrient_concentration();
+		Mesh(double x_start, double y_start, double increment);
+		void update_mesh_pts_vec(unique_ptr<Mesh_Pt> new_mesh_pt, int index);
+		void get_mesh_pts_vec(vector<Mesh_Pt*>& mesh_points);
+		//key of the bin nearest loc, safe to call from any thread
+		int64_t get_bin_key(const Coord& loc) const;
+		//index of the bin with this key, making it if needed
+		int get_bin_index(int64_t key);
+		//position of a bin along a Morton curve over the grid
+		static uint64_t get_morton_key(int64_t key);
+		//cell list of the first num_cells cells of cell_bins
+		void build_cell_list(const vector<int>& cell_bins, int num_cells);
+		Cell_Span get_cells_in_bin(int index) const;
+		const vector<int>& get_occupied_bins() const {return occupied_bins;}
+		Mesh_Pt* get_mesh_pt(int index) {return mesh_pts[index].first.get();}
+		const int* get_stencil(int index) const {return &stencil[index*STENCIL_SIZE];}
+		int get_num_bins() const {return mesh_pts.size();}
 		double get_nutrient_conc(int bin_id);
+		//bins are remade in the same order so bin ids carry over
+		void save(Checkpoint_Out& out);
+		void load(Checkpoint_In& in);
 };
 
 //end mesh class
@@ -10,8 +10,6 @@
 class Mesh;
 //*************************************
 //include dependencies
-#include <boost/enable_shared_from_this.hpp>
-#include <boost/shared_ptr.hpp>
 #include <string>
 #include <vector>
 #include <fstream>
@@ -24,27 +22,21 @@ class Mesh;
 #include "coord.h"
 //**************************************************
 //mesh_pt class declaration
-class Mesh_Pt: public enable_shared_from_this<Mesh_Pt>{
+class Mesh_Pt {
 	private:
-		vector<shared_ptr<Cell>> cells;
-		shared_ptr<Mesh> my_mesh;
+		//owned by the mesh
+		Mesh* my_mesh;
 		Coord center;
 		double nutrient_conc;
 		int index;
-		vector<shared_ptr<Mesh_Pt>> neighbors;
 	public:
 		//constructor
-		Mesh_Pt(shared_ptr<Mesh> my_mesh, double x, double y, int index);
-		void find_neighbor_bins();
+		Mesh_Pt(Mesh* my_mesh, double x, double y, int index);
 		int get_index(){return index;}
 		Coord get_center(){return center;};
-		void get_cells(vector<shared_ptr<Cell>>& neighbors);
-		void get_neighbor_bins(vector<shared_ptr<Mesh_Pt>>& neighbor_bins);
-		void add_cells_to_neighbor_vec(vector<shared_ptr<Cell>>&  neighbor_cells);
-		void add_cell(shared_ptr<Cell>& new_cell);
-		void clear_cells_vec();
-		void calculate_nutrient_concentration();
+		void calculate_nutrient_concentration(double total_mass, double step_dt);
 		double get_nutrient_conc(){return nutrient_conc;}
+		void set_nutrient_conc(double conc){nutrient_conc = conc;}
 };
 
 
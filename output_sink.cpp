@@ -0,0 +1,122 @@
+//output_sink.cpp
+
+//******************************************
+//Include Dependencies
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <string>
+#include <memory>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "output_sink.h"
+using namespace std;
+//****************************************
+//Public Member Functions for File_Sink
+
+//constructor
+File_Sink::File_Sink(const string& prefix, const string& extension, bool binary){
+	this->prefix = prefix;
+	this->extension = extension;
+	this->binary = binary;
+	return;
+}
+ostream& File_Sink::begin_frame(int number){
+	filename = prefix + to_string(number) + extension;
+	ofs.clear();
+	ofs.open(filename.c_str(),binary ? ios::out | ios::binary : ios::out);
+	return ofs;
+}
+bool File_Sink::end_frame(){
+	ofs.close();
+	return !ofs.fail();
+}
+//****************************************
+//Public Member Functions for Stream_Sink
+
+//constructor
+Stream_Sink::Stream_Sink(int fd, const string& name){
+	this->fd = fd;
+	this->name = name;
+	this->number = 0;
+	return;
+}
+Stream_Sink::~Stream_Sink(){
+	close(fd);
+	return;
+}
+ostream& Stream_Sink::begin_frame(int number){
+	this->number = number;
+	frame.str("");
+	frame.clear();
+	return frame;
+}
+bool Stream_Sink::end_frame(){
+	string payload = frame.str();
+	int32_t frame_number = number;
+	uint64_t size = payload.size();
+	return write_all((const char*)&frame_number,sizeof(frame_number)) && write_all((const char*)&size,sizeof(size)) && write_all(payload.data(),payload.size());
+}
+//****************************************
+//Private Member Functions for Stream_Sink
+
+bool Stream_Sink::write_all(const char* bytes, size_t size){
+	while(size > 0){
+		ssize_t written = write(fd,bytes,size);
+		if(written < 0){
+			if(errno == EINTR){
+				continue;
+			}
+			return false;
+		}
+		bytes += written;
+		size -= written;
+	}
+	return true;
+}
+//****************************************
+//Sink Factory
+
+unique_ptr<Output_Sink> open_output_sink(const string& spec, const string& prefix, const string& extension, bool binary){
+	if(spec == "file"){
+		return unique_ptr<Output_Sink>(new File_Sink(prefix,extension,binary));
+	}
+	//a consumer that goes away should cost frames, not the run
+	signal(SIGPIPE,SIG_IGN);
+	int fd = -1;
+	if(spec == "stdout"){
+		//frames keep the real stdout, log lines move to stderr
+		cout.flush();
+		fd = dup(STDOUT_FILENO);
+		if(fd >= 0){
+			dup2(STDERR_FILENO,STDOUT_FILENO);
+		}
+	}else if(spec.compare(0,5,"pipe:") == 0){
+		//opening a named pipe waits for its reader
+		fd = open(spec.substr(5).c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644);
+	}else if(spec.compare(0,5,"unix:") == 0){
+		string path = spec.substr(5);
+		struct sockaddr_un address;
+		memset(&address,0,sizeof(address));
+		address.sun_family = AF_UNIX;
+		if(path.empty() || (path.size() >= sizeof(address.sun_path))){
+			return unique_ptr<Output_Sink>();
+		}
+		strncpy(address.sun_path,path.c_str(),sizeof(address.sun_path)-1);
+		fd = socket(AF_UNIX,SOCK_STREAM,0);
+		if((fd >= 0) && (connect(fd,(struct sockaddr*)&address,sizeof(address)) != 0)){
+			close(fd);
+			fd = -1;
+		}
+	}
+	if(fd < 0){
+		return unique_ptr<Output_Sink>();
+	}
+	return unique_ptr<Output_Sink>(new Stream_Sink(fd,spec));
+}
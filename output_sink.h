@@ -0,0 +1,92 @@
+//output_sink.h
+
+//*********************************************************
+// Include Guards
+#ifndef _OUTPUT_SINK_H_INCLUDED_
+#define _OUTPUT_SINK_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+
+//*********************************************************
+// include dependencies
+#include <stdint.h>
+#include <string>
+#include <memory>
+#include <ostream>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+//*********************************************************
+//Where Snapshot_Writer puts frames, picked with -output_sink:
+//  file         a file per frame next to the checkpoints (default)
+//  stdout       standard output, log lines go to stderr instead
+//  pipe:PATH    a named pipe or any other file opened for writing
+//  unix:PATH    a unix domain stream socket the consumer listens on
+//Streamed frames are int32 frame number, uint64 payload size and
+//the payload, which is what the file would have held. Both numbers
+//are in the writer's byte order.
+
+//*********************************************************
+// Output_Sink Class Declaration
+
+class Output_Sink {
+	public:
+		virtual ~Output_Sink() {}
+		//stream to write frame number into, sent by end_frame
+		virtual ostream& begin_frame(int number) = 0;
+		//false if the frame was lost
+		virtual bool end_frame() = 0;
+		//the file or stream last written, for messages
+		virtual string get_name() const = 0;
+};
+
+//End Output_Sink Class
+//**************************************************************
+// File_Sink Class Declaration
+
+//frame n goes to prefix + n + extension
+class File_Sink : public Output_Sink {
+	private:
+		string prefix;
+		string extension;
+		bool binary;
+		string filename;
+		ofstream ofs;
+	public:
+		//constructor
+		File_Sink(const string& prefix, const string& extension, bool binary);
+		ostream& begin_frame(int number);
+		bool end_frame();
+		string get_name() const {return filename;}
+};
+
+//End File_Sink Class
+//**************************************************************
+// Stream_Sink Class Declaration
+
+//length prefixed frames on an open descriptor, which it closes
+class Stream_Sink : public Output_Sink {
+	private:
+		int fd;
+		string name;
+		int number;
+		ostringstream frame;
+		bool write_all(const char* bytes, size_t size);
+	public:
+		//constructor
+		Stream_Sink(int fd, const string& name);
+		~Stream_Sink();
+		ostream& begin_frame(int number);
+		bool end_frame();
+		string get_name() const {return name;}
+};
+
+//End Stream_Sink Class
+//**************************************************************
+//opens the sink named by spec (see above), NULL if it can not
+unique_ptr<Output_Sink> open_output_sink(const string& spec, const string& prefix, const string& extension, bool binary);
+
+#endif
+
@@ -19,7 +19,7 @@
 const int end_time = 1680;
 const int NUM_STEPS = 2000000;
 
-//timestep
+//timestep, with -adaptive_dt a step can span several of these
 const double dt = (double)end_time/(double)NUM_STEPS;
 
 //frequency of output for visualization
@@ -40,6 +40,9 @@ const double ELASTIC_MOD = 1000;
 const double K_ADH = 25;
 const double K_BEND = 8;
 const double ADHESION_STRENGTH = 12;
+//adhesion acts while cells are within this distance
+//of touching (microns)
+const double ADH_RANGE = 1;
 const double k_axial_frac = .5;
 //chou model params
 const double k_r = 1; 
@@ -49,6 +52,8 @@ const double k_a = .2;
 //const double P_0 = 50;
 //const double r_LOGISTIC = 1;
 const double K_LOGISTIC = 100;
+//largest RK4 step (minutes) when protein is brought up to date
+const double PROTEIN_STEP = .01;
 //const double A_LOGISTIC = 20;
 //signaling params DNPM
 const double alpha = .0154;
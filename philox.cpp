@@ -0,0 +1,62 @@
+//philox.cpp
+
+//******************************************
+//Include Dependencies
+#include <stdint.h>
+#include "checkpoint.h"
+#include "philox.h"
+using namespace std;
+//******************************************
+//Philox4x32 multipliers and Weyl key increments
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+static void philox4x32_10(uint32_t ctr[4], uint32_t key0, uint32_t key1){
+	for(int round = 0; round < 10; round++){
+		uint64_t prod0 = (uint64_t)PHILOX_M0*ctr[0];
+		uint64_t prod1 = (uint64_t)PHILOX_M1*ctr[2];
+		uint32_t next[4];
+		next[0] = (uint32_t)(prod1 >> 32) ^ ctr[1] ^ key0;
+		next[1] = (uint32_t)prod1;
+		next[2] = (uint32_t)(prod0 >> 32) ^ ctr[3] ^ key1;
+		next[3] = (uint32_t)prod0;
+		for(int i = 0; i < 4; i++){
+			ctr[i] = next[i];
+		}
+		key0 += PHILOX_W0;
+		key1 += PHILOX_W1;
+	}
+	return;
+}
+Random_Stream::Random_Stream(uint64_t seed, uint32_t stream, uint32_t event){
+	this->seed = seed;
+	this->stream = stream;
+	this->event = event;
+	this->draw = 0;
+	return;
+}
+double Random_Stream::uniform(double a, double b){
+	uint32_t ctr[4] = {stream, event, draw, 0};
+	draw++;
+	philox4x32_10(ctr,(uint32_t)seed,(uint32_t)(seed >> 32));
+	//top 53 bits of the first two words
+	uint64_t bits = (((uint64_t)ctr[0] << 32) | ctr[1]) >> 11;
+	double u = bits*(1.0/9007199254740992.0);
+	return (u*(b-a)) + a;
+}
+void Random_Stream::save(Checkpoint_Out& out) const{
+	out.put(seed);
+	out.put(stream);
+	out.put(event);
+	out.put(draw);
+	return;
+}
+void Random_Stream::load(Checkpoint_In& in){
+	seed = in.get_uint64();
+	stream = in.get_uint();
+	event = in.get_uint();
+	draw = in.get_uint();
+	return;
+}
@@ -0,0 +1,45 @@
+//philox.h
+
+//*********************************************************
+// Include Guards
+#ifndef _PHILOX_H_INCLUDED_
+#define _PHILOX_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+
+//*********************************************************
+// include dependencies
+#include <stdint.h>
+#include "checkpoint.h"
+//*********************************************************
+//stream id for draws made by the colony rather than a cell
+const uint32_t COLONY_STREAM = 0xFFFFFFFF;
+
+//*********************************************************
+// Random_Stream Class Declaration
+
+//Counter based random numbers from Philox4x32-10 (Salmon et al.
+//2011). Every draw is a function of (seed, stream, event, draw)
+//alone, so any thread can draw for any cell without locks and
+//the numbers do not depend on the thread count. Cells use their
+//rank as the stream and count their own events.
+class Random_Stream {
+	private:
+		uint64_t seed;
+		uint32_t stream;
+		uint32_t event;
+		uint32_t draw;
+	public:
+		//constructor
+		Random_Stream(uint64_t seed, uint32_t stream, uint32_t event);
+		//next number, uniform on [a,b)
+		double uniform(double a, double b);
+		void save(Checkpoint_Out& out) const;
+		void load(Checkpoint_In& in);
+};
+
+//End Random_Stream Class
+//**************************************************************
+#endif
+
@@ -0,0 +1,414 @@
+//series.cpp
+
+//******************************************
+//Include Dependencies
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "snapshot.h"
+#include "series.h"
+using namespace std;
+//******************************************
+//header is magic, version, byte order, three quanta, keyframe interval
+static const uint64_t SERIES_HEADER_SIZE = 8 + 4 + 4 + 3*8 + 4;
+//chunks start with a type byte and a uint32 payload size
+static const uint64_t CHUNK_HEADER_SIZE = 1 + 4;
+
+//varints hold 7 bits a byte, low bits first, zigzag maps
+//0,-1,1,-2,... to 0,1,2,3,... so small deltas of either sign
+//take one byte
+static void put_varint(string& out, uint64_t value){
+	while(value >= 0x80){
+		out.push_back((char)((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.push_back((char)value);
+	return;
+}
+static void put_signed(string& out, int64_t value){
+	put_varint(out,((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+	return;
+}
+template<typename T>
+static void put_raw(string& out, T value){
+	out.append((const char*)&value,sizeof(T));
+	return;
+}
+static void put_column(string& out, const vector<double>& values, double quantum, vector<int64_t>& prev){
+	for(unsigned int i = 0; i < values.size(); i++){
+		int64_t q = llround(values[i]/quantum);
+		put_signed(out,q - prev[i]);
+		prev[i] = q;
+	}
+	return;
+}
+static void put_column(string& out, const vector<int32_t>& values, vector<int64_t>& prev){
+	for(unsigned int i = 0; i < values.size(); i++){
+		put_signed(out,values[i] - prev[i]);
+		prev[i] = values[i];
+	}
+	return;
+}
+static void put_path(string& out, const vector<uint32_t>& offsets, const vector<int32_t>& values, int cell){
+	put_varint(out,offsets[cell+1] - offsets[cell]);
+	for(uint32_t k = offsets[cell]; k < offsets[cell+1]; k++){
+		put_signed(out,values[k]);
+	}
+	return;
+}
+//reads back what the put functions wrote, ok turns false
+//instead of reading past the end
+class Byte_Reader {
+	private:
+		const string& data;
+		size_t pos;
+	public:
+		bool ok;
+		Byte_Reader(const string& data) : data(data), pos(0), ok(true) {}
+		uint64_t get_varint(){
+			uint64_t value = 0;
+			for(int shift = 0; shift < 64; shift += 7){
+				if(pos >= data.size()){
+					ok = false;
+					return 0;
+				}
+				uint8_t byte = data[pos++];
+				value |= (uint64_t)(byte & 0x7F) << shift;
+				if(!(byte & 0x80)){
+					return value;
+				}
+			}
+			ok = false;
+			return 0;
+		}
+		int64_t get_signed(){
+			uint64_t value = get_varint();
+			return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+		}
+		template<typename T> T get_raw(){
+			T value = 0;
+			if(pos + sizeof(T) > data.size()){
+				ok = false;
+				return value;
+			}
+			memcpy(&value,data.data() + pos,sizeof(T));
+			pos += sizeof(T);
+			return value;
+		}
+		size_t remaining() const {return data.size() - pos;}
+};
+static bool read_chunk(ifstream& ifs, uint8_t& type, string& payload){
+	uint32_t size = 0;
+	type = ifs.get();
+	ifs.read((char*)&size,sizeof(size));
+	if(!ifs.good()){
+		return false;
+	}
+	payload.resize(size);
+	ifs.read(&payload[0],size);
+	return ifs.good();
+}
+//****************************************
+//Public Member Functions for Series_Encoder
+
+//constructor
+Series_Encoder::Series_Encoder(const string& filename, int64_t first_tick){
+	//the first frame is always a keyframe
+	this->filename = filename;
+	this->since_keyframe = SERIES_KEYFRAME_INTERVAL;
+	this->prev_cells = 0;
+	if((first_tick > 0) && trim(filename,first_tick)){
+		ofs.open(filename.c_str(),ios::binary | ios::app);
+		return;
+	}
+	keyframes.clear();
+	ofs.open(filename.c_str(),ios::binary | ios::trunc);
+	ofs.write(SERIES_MAGIC,sizeof(SERIES_MAGIC));
+	uint32_t header[2] = {SERIES_VERSION,0x01020304};
+	double quanta[3] = {POSITION_QUANTUM,PROTEIN_QUANTUM,CP_QUANTUM};
+	ofs.write((const char*)header,sizeof(header));
+	ofs.write((const char*)quanta,sizeof(quanta));
+	ofs.write((const char*)&SERIES_KEYFRAME_INTERVAL,sizeof(SERIES_KEYFRAME_INTERVAL));
+	this->offset = SERIES_HEADER_SIZE;
+	return;
+}
+bool Series_Encoder::trim(const string& filename, int64_t first_tick){
+	//a restarted run keeps the frames before its first tick, and
+	//drops later ones, the index written when the last job stopped
+	//and any chunk cut short when the job ended
+	Series_Decoder existing(filename);
+	if(!existing.good()){
+		return false;
+	}
+	ifstream ifs(filename.c_str(),ios::binary);
+	ifs.seekg(SERIES_HEADER_SIZE);
+	uint64_t end = SERIES_HEADER_SIZE;
+	uint8_t type;
+	string chunk;
+	keyframes.clear();
+	while(read_chunk(ifs,type,chunk)){
+		if(type == INDEX_CHUNK){
+			break;
+		}
+		if((type == KEY_FRAME_CHUNK) || (type == DELTA_FRAME_CHUNK)){
+			Byte_Reader reader(chunk);
+			int64_t tick = reader.get_varint();
+			if(tick >= first_tick){
+				break;
+			}
+			if(type == KEY_FRAME_CHUNK){
+				keyframes.push_back(make_pair(tick,end));
+			}
+		}
+		end += CHUNK_HEADER_SIZE + chunk.size();
+	}
+	ifs.close();
+	if(truncate(filename.c_str(),end) != 0){
+		return false;
+	}
+	this->offset = end;
+	return true;
+}
+void Series_Encoder::write_chunk(uint8_t type){
+	uint32_t size = payload.size();
+	ofs.put(type);
+	ofs.write((const char*)&size,sizeof(size));
+	ofs.write(payload.data(),size);
+	offset += CHUNK_HEADER_SIZE + size;
+	return;
+}
+bool Series_Encoder::write_frame(const Snapshot& frame){
+	int num_cells = frame.size();
+	bool keyframe = (since_keyframe >= SERIES_KEYFRAME_INTERVAL) || (num_cells < prev_cells);
+	if(keyframe){
+		prev_cells = 0;
+		since_keyframe = 0;
+		keyframes.push_back(make_pair(frame.tick,offset));
+	}
+	since_keyframe++;
+	int num_old = prev_cells;
+	payload.clear();
+	put_varint(payload,frame.tick);
+	put_raw(payload,frame.sim_time);
+	put_varint(payload,num_cells);
+	put_varint(payload,num_old);
+	for(int i = num_old; i < num_cells; i++){
+		put_signed(payload,frame.sector[i]);
+		put_signed(payload,frame.mother_rank[i]);
+		put_signed(payload,frame.four_lineage[i]);
+		put_path(payload,frame.g_lineage_offsets,frame.g_lineage,i);
+		put_path(payload,frame.lineage_offsets,frame.lineage,i);
+	}
+	vector<int64_t>* prev[8] = {&prev_x,&prev_y,&prev_radius,&prev_protein,&prev_CP,&prev_age,&prev_T_age,&prev_bin_id};
+	for(int c = 0; c < 8; c++){
+		//new cells and every cell of a keyframe start from zero
+		prev[c]->resize(num_old);
+		prev[c]->resize(num_cells,0);
+	}
+	put_column(payload,frame.x,POSITION_QUANTUM,prev_x);
+	put_column(payload,frame.y,POSITION_QUANTUM,prev_y);
+	put_column(payload,frame.radius,POSITION_QUANTUM,prev_radius);
+	put_column(payload,frame.protein,PROTEIN_QUANTUM,prev_protein);
+	put_column(payload,frame.CP,CP_QUANTUM,prev_CP);
+	put_column(payload,frame.age,prev_age);
+	put_column(payload,frame.T_age,prev_T_age);
+	put_column(payload,frame.bin_id,prev_bin_id);
+	for(int i = 0; i < num_cells; i++){
+		payload.push_back((char)(frame.phase[i]*2 + frame.is_bud[i]));
+	}
+	write_chunk(keyframe ? KEY_FRAME_CHUNK : DELTA_FRAME_CHUNK);
+	prev_cells = num_cells;
+	//flushed so a failed write shows up with its frame
+	ofs.flush();
+	return ofs.good();
+}
+bool Series_Encoder::close(){
+	if(!ofs.is_open()){
+		return false;
+	}
+	uint64_t index_offset = offset;
+	payload.clear();
+	put_varint(payload,keyframes.size());
+	for(unsigned int k = 0; k < keyframes.size(); k++){
+		put_varint(payload,keyframes[k].first);
+		put_varint(payload,keyframes[k].second);
+	}
+	put_raw(payload,index_offset);
+	payload.append(SERIES_END_MAGIC,sizeof(SERIES_END_MAGIC));
+	write_chunk(INDEX_CHUNK);
+	ofs.close();
+	return !ofs.fail();
+}
+//****************************************
+//Public Member Functions for Series_Decoder
+
+//constructor
+Series_Decoder::Series_Decoder(const string& filename){
+	ifs.open(filename.c_str(),ios::binary);
+	char magic[sizeof(SERIES_MAGIC)];
+	uint32_t header[2] = {0,0};
+	double quanta[3] = {0,0,0};
+	uint32_t interval = 0;
+	ifs.read(magic,sizeof(magic));
+	ifs.read((char*)header,sizeof(header));
+	ifs.read((char*)quanta,sizeof(quanta));
+	ifs.read((char*)&interval,sizeof(interval));
+	if(memcmp(magic,SERIES_MAGIC,sizeof(magic)) || (header[0] != SERIES_VERSION) || (header[1] != 0x01020304)){
+		ifs.setstate(ios::failbit);
+	}
+	this->position_quantum = quanta[0];
+	this->protein_quantum = quanta[1];
+	this->CP_quantum = quanta[2];
+	return;
+}
+bool Series_Decoder::read_frame(Snapshot& frame){
+	uint8_t type;
+	string chunk;
+	while(ifs.good() && read_chunk(ifs,type,chunk)){
+		if((type == KEY_FRAME_CHUNK) || (type == DELTA_FRAME_CHUNK)){
+			return decode_frame(chunk,type == KEY_FRAME_CHUNK,frame);
+		}
+	}
+	return false;
+}
+bool Series_Decoder::decode_frame(const string& chunk, bool keyframe, Snapshot& frame){
+	Byte_Reader reader(chunk);
+	frame.tick = reader.get_varint();
+	frame.sim_time = reader.get_raw<double>();
+	uint64_t cell_count = reader.get_varint();
+	uint64_t old_count = reader.get_varint();
+	//every cell has at least a byte in each of the 8 delta columns
+	//and its state byte, so larger counts cannot be in this chunk
+	if(!reader.ok || (old_count > cell_count) || (cell_count > reader.remaining()/9)){
+		return false;
+	}
+	int num_cells = cell_count;
+	int num_old = old_count;
+	if(keyframe != (num_old == 0)){
+		return false;
+	}
+	if(keyframe){
+		sector.clear();
+		mother_rank.clear();
+		four_lineage.clear();
+		g_lineage.clear();
+		lineage.clear();
+	}
+	if(num_old != (int)sector.size()){
+		//a delta frame needs the frame before it
+		return false;
+	}
+	for(int i = num_old; (i < num_cells) && reader.ok; i++){
+		sector.push_back(reader.get_signed());
+		mother_rank.push_back(reader.get_signed());
+		four_lineage.push_back(reader.get_signed());
+		g_lineage.push_back(vector<int32_t>());
+		lineage.push_back(vector<int32_t>());
+		vector<int32_t>* paths[2] = {&g_lineage.back(),&lineage.back()};
+		for(int p = 0; p < 2; p++){
+			uint64_t length = reader.get_varint();
+			for(uint64_t k = 0; (k < length) && reader.ok; k++){
+				paths[p]->push_back(reader.get_signed());
+			}
+		}
+	}
+	if(!reader.ok){
+		return false;
+	}
+	vector<int64_t>* prev[8] = {&prev_x,&prev_y,&prev_radius,&prev_protein,&prev_CP,&prev_age,&prev_T_age,&prev_bin_id};
+	for(int c = 0; c < 8; c++){
+		prev[c]->resize(num_old);
+		prev[c]->resize(num_cells,0);
+		for(int i = 0; i < num_cells; i++){
+			(*prev[c])[i] += reader.get_signed();
+		}
+	}
+	frame.resize(num_cells);
+	for(int i = 0; i < num_cells; i++){
+		uint8_t state = reader.get_raw<uint8_t>();
+		frame.rank[i] = i;
+		frame.x[i] = prev_x[i]*position_quantum;
+		frame.y[i] = prev_y[i]*position_quantum;
+		frame.radius[i] = prev_radius[i]*position_quantum;
+		frame.protein[i] = prev_protein[i]*protein_quantum;
+		frame.CP[i] = prev_CP[i]*CP_quantum;
+		frame.age[i] = prev_age[i];
+		frame.T_age[i] = prev_T_age[i];
+		frame.bin_id[i] = prev_bin_id[i];
+		frame.phase[i] = state/2;
+		frame.is_bud[i] = state%2;
+		frame.sector[i] = sector[i];
+		frame.mother_rank[i] = mother_rank[i];
+		frame.four_lineage[i] = four_lineage[i];
+		frame.g_lineage_offsets[i+1] = frame.g_lineage_offsets[i] + g_lineage[i].size();
+		frame.lineage_offsets[i+1] = frame.lineage_offsets[i] + lineage[i].size();
+	}
+	frame.g_lineage.clear();
+	frame.lineage.clear();
+	for(int i = 0; i < num_cells; i++){
+		frame.g_lineage.insert(frame.g_lineage.end(),g_lineage[i].begin(),g_lineage[i].end());
+		frame.lineage.insert(frame.lineage.end(),lineage[i].begin(),lineage[i].end());
+	}
+	return reader.ok;
+}
+bool Series_Decoder::seek(int64_t tick){
+	//the index at the end when the run finished, otherwise
+	//a scan over the chunk headers
+	vector<pair<int64_t,uint64_t>> keyframes;
+	ifs.clear();
+	ifs.seekg(0,ios::end);
+	uint64_t file_size = ifs.tellg();
+	uint64_t index_offset = 0;
+	char end_magic[sizeof(SERIES_END_MAGIC)];
+	uint8_t type = 0;
+	string chunk;
+	if(file_size >= SERIES_HEADER_SIZE + 16){
+		ifs.seekg(file_size - 16);
+		ifs.read((char*)&index_offset,sizeof(index_offset));
+		ifs.read(end_magic,sizeof(end_magic));
+	}
+	if(ifs.good() && !memcmp(end_magic,SERIES_END_MAGIC,sizeof(end_magic)) && (index_offset < file_size)){
+		ifs.seekg(index_offset);
+		if(read_chunk(ifs,type,chunk) && (type == INDEX_CHUNK)){
+			Byte_Reader reader(chunk);
+			uint64_t count = reader.get_varint();
+			for(uint64_t k = 0; (k < count) && reader.ok; k++){
+				int64_t key_tick = reader.get_varint();
+				uint64_t key_offset = reader.get_varint();
+				keyframes.push_back(make_pair(key_tick,key_offset));
+			}
+		}
+	}else{
+		ifs.clear();
+		ifs.seekg(SERIES_HEADER_SIZE);
+		uint64_t chunk_offset = SERIES_HEADER_SIZE;
+		while(read_chunk(ifs,type,chunk)){
+			if(type == KEY_FRAME_CHUNK){
+				Byte_Reader reader(chunk);
+				keyframes.push_back(make_pair((int64_t)reader.get_varint(),chunk_offset));
+			}
+			chunk_offset += CHUNK_HEADER_SIZE + chunk.size();
+		}
+	}
+	int found = -1;
+	for(unsigned int k = 0; k < keyframes.size(); k++){
+		if(keyframes[k].first <= tick){
+			found = k;
+		}
+	}
+	ifs.clear();
+	if(found < 0){
+		return false;
+	}
+	ifs.seekg(keyframes[found].second);
+	sector.clear();
+	mother_rank.clear();
+	four_lineage.clear();
+	g_lineage.clear();
+	lineage.clear();
+	return true;
+}
@@ -0,0 +1,125 @@
+//series.h
+
+//*********************************************************
+// Include Guards
+#ifndef _SERIES_H_INCLUDED_
+#define _SERIES_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+
+//*********************************************************
+// include dependencies
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "snapshot.h"
+
+using namespace std;
+//*********************************************************
+//Time series of frames in one file. After the header
+//  magic "YSERIES1", uint32 version, uint32 0x01020304,
+//  float64 position, protein and CP quanta, uint32 keyframe interval
+//the file is a run of chunks: uint8 type, uint32 payload size, payload.
+//A frame payload is
+//  varint tick, float64 sim_time, varint num_cells, varint num_old
+//  for each cell from num_old on: sector, mother_rank, four_lineage,
+//    g_lineage and lineage (length then values), which never change
+//  columns over all cells: x, y, radius, protein, CP, age, T_age,
+//    bin_id as zigzag varint deltas from the cell's previous frame,
+//    then one byte of phase*2 + is_bud per cell
+//x, y, radius, protein and CP are rounded to their quantum first,
+//deltas are taken between rounded values so errors do not add up.
+//Cells 0..num_old-1 carry over from the previous frame. A keyframe
+//has num_old = 0 and so decodes on its own. An index chunk, written
+//when the run ends, lists (tick, offset) of every keyframe and ends
+//with its own offset and "YSERIEND", the last 16 bytes of the file.
+const char SERIES_MAGIC[8] = {'Y','S','E','R','I','E','S','1'};
+const char SERIES_END_MAGIC[8] = {'Y','S','E','R','I','E','N','D'};
+const uint32_t SERIES_VERSION = 1;
+const uint8_t KEY_FRAME_CHUNK = 'K';
+const uint8_t DELTA_FRAME_CHUNK = 'D';
+const uint8_t INDEX_CHUNK = 'I';
+const uint32_t SERIES_KEYFRAME_INTERVAL = 16;
+//microns for x, y and radius
+const double POSITION_QUANTUM = 1e-5;
+const double PROTEIN_QUANTUM = 1e-6;
+const double CP_QUANTUM = 1e-7;
+
+//*********************************************************
+// Series_Encoder Class Declaration
+
+class Series_Encoder {
+	private:
+		string filename;
+		ofstream ofs;
+		uint64_t offset;
+		//frames since the last keyframe
+		uint32_t since_keyframe;
+		vector<pair<int64_t,uint64_t>> keyframes;
+		//previous frame, rounded to the quanta
+		int prev_cells;
+		vector<int64_t> prev_x;
+		vector<int64_t> prev_y;
+		vector<int64_t> prev_radius;
+		vector<int64_t> prev_protein;
+		vector<int64_t> prev_CP;
+		vector<int64_t> prev_age;
+		vector<int64_t> prev_T_age;
+		vector<int64_t> prev_bin_id;
+		string payload;
+		void write_chunk(uint8_t type);
+		bool trim(const string& filename, int64_t first_tick);
+	public:
+		//starts a new file, or with first_tick > 0 carries on an
+		//existing one, dropping its frames from first_tick on
+		Series_Encoder(const string& filename, int64_t first_tick);
+		bool good() const {return ofs.good();}
+		const string& get_filename() const {return filename;}
+		//false if the frame could not be written
+		bool write_frame(const Snapshot& frame);
+		//writes the index, false if anything failed
+		bool close();
+};
+
+//End Series_Encoder Class
+//**************************************************************
+// Series_Decoder Class Declaration
+
+class Series_Decoder {
+	private:
+		ifstream ifs;
+		double position_quantum;
+		double protein_quantum;
+		double CP_quantum;
+		//previous frame and the attributes that never change
+		vector<int64_t> prev_x;
+		vector<int64_t> prev_y;
+		vector<int64_t> prev_radius;
+		vector<int64_t> prev_protein;
+		vector<int64_t> prev_CP;
+		vector<int64_t> prev_age;
+		vector<int64_t> prev_T_age;
+		vector<int64_t> prev_bin_id;
+		vector<int32_t> sector;
+		vector<int32_t> mother_rank;
+		vector<int32_t> four_lineage;
+		vector<vector<int32_t>> g_lineage;
+		vector<vector<int32_t>> lineage;
+		bool decode_frame(const string& payload, bool keyframe, Snapshot& frame);
+	public:
+		//constructor, checks the header
+		Series_Decoder(const string& filename);
+		bool good() const {return ifs.good();}
+		//next frame in the file, false at the end
+		bool read_frame(Snapshot& frame);
+		//moves to the last keyframe at or before tick, false if
+		//there is none
+		bool seek(int64_t tick);
+};
+
+//End Series_Decoder Class
+//**************************************************************
+#endif
+
@@ -0,0 +1,332 @@
+//snapshot.cpp
+
+//******************************************
+//Include Dependencies
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include "snapshot.h"
+#include "series.h"
+#include "output_sink.h"
+using namespace std;
+//******************************************
+//binary output helpers
+
+template<typename T>
+static void write_value(ostream& os, T value){
+	os.write((const char*)&value,sizeof(T));
+	return;
+}
+//zeros from the end of bytes up to the next multiple of
+//SNAPSHOT_ALIGNMENT
+static void write_padding(ostream& os, size_t bytes){
+	static const char padding[SNAPSHOT_ALIGNMENT] = {0};
+	os.write(padding,(SNAPSHOT_ALIGNMENT - bytes%SNAPSHOT_ALIGNMENT)%SNAPSHOT_ALIGNMENT);
+	return;
+}
+template<typename T>
+static void write_array(ostream& os, const vector<T>& values){
+	size_t bytes = values.size()*sizeof(T);
+	os.write((const char*)values.data(),bytes);
+	write_padding(os,bytes);
+	return;
+}
+static void write_name(ostream& os, const char* name){
+	char padded[SNAPSHOT_NAME_SIZE];
+	memset(padded,0,SNAPSHOT_NAME_SIZE);
+	strncpy(padded,name,SNAPSHOT_NAME_SIZE-1);
+	os.write(padded,SNAPSHOT_NAME_SIZE);
+	return;
+}
+//narrowest type that holds every value
+static Column_Type get_int_type(const vector<int32_t>& values){
+	int32_t low = 0;
+	int32_t high = 0;
+	for(int32_t value : values){
+		low = min(low,value);
+		high = max(high,value);
+	}
+	if((low >= INT8_MIN) && (high <= INT8_MAX)){
+		return INT8_COLUMN;
+	}
+	if((low >= INT16_MIN) && (high <= INT16_MAX)){
+		return INT16_COLUMN;
+	}
+	return INT32_COLUMN;
+}
+static Column_Type get_uint_type(const vector<uint32_t>& values){
+	uint32_t high = 0;
+	for(uint32_t value : values){
+		high = max(high,value);
+	}
+	if(high <= UINT8_MAX){
+		return UINT8_COLUMN;
+	}
+	if(high <= UINT16_MAX){
+		return UINT16_COLUMN;
+	}
+	return UINT32_COLUMN;
+}
+//writes values converted to type as one array
+template<typename T, typename V>
+static void write_converted(ostream& os, const vector<V>& values){
+	vector<T> converted(values.begin(),values.end());
+	write_array(os,converted);
+	return;
+}
+template<typename V>
+static void write_as(ostream& os, const vector<V>& values, Column_Type type){
+	switch(type){
+		case UINT8_COLUMN: write_converted<uint8_t>(os,values); break;
+		case UINT16_COLUMN: write_converted<uint16_t>(os,values); break;
+		case UINT32_COLUMN: write_converted<uint32_t>(os,values); break;
+		case INT8_COLUMN: write_converted<int8_t>(os,values); break;
+		case INT16_COLUMN: write_converted<int16_t>(os,values); break;
+		case INT32_COLUMN: write_converted<int32_t>(os,values); break;
+		case FLOAT32_COLUMN: write_converted<float>(os,values); break;
+		case FLOAT64_COLUMN: write_converted<double>(os,values); break;
+	}
+	return;
+}
+//a column of a binary frame, one of the vectors is set
+struct Out_Column {
+	const char* name;
+	Column_Type type;
+	const vector<uint8_t>* bytes;
+	const vector<int32_t>* ints;
+	const vector<double>* reals;
+};
+static Out_Column byte_column(const char* name, const vector<uint8_t>& values){
+	Out_Column column = {name,UINT8_COLUMN,&values,NULL,NULL};
+	return column;
+}
+static Out_Column int_column(const char* name, const vector<int32_t>& values){
+	Out_Column column = {name,get_int_type(values),NULL,&values,NULL};
+	return column;
+}
+static Out_Column real_column(const char* name, const vector<double>& values, Column_Type type){
+	Out_Column column = {name,type,NULL,NULL,&values};
+	return column;
+}
+//a path blob keeps a length per cell rather than the offsets,
+//which would need 32 bits in all but small frames
+struct Out_Blob {
+	const char* name;
+	vector<uint32_t> lengths;
+	Column_Type length_type;
+	const vector<int32_t>* values;
+	Column_Type value_type;
+};
+static Out_Blob path_blob(const char* name, const vector<uint32_t>& offsets, const vector<int32_t>& values){
+	Out_Blob blob;
+	blob.name = name;
+	blob.lengths.resize(offsets.size()-1);
+	for(unsigned int i = 0; i+1 < offsets.size(); i++){
+		blob.lengths[i] = offsets[i+1] - offsets[i];
+	}
+	blob.length_type = get_uint_type(blob.lengths);
+	blob.values = &values;
+	blob.value_type = get_int_type(values);
+	return blob;
+}
+static void write_path(ostream& os, const vector<uint32_t>& offsets, const vector<int32_t>& values, int cell){
+	for(uint32_t k = offsets[cell]; k < offsets[cell+1]; k++){
+		os << "/" << values[k];
+	}
+	return;
+}
+//****************************************
+//Public Member Functions for snapshot.cpp
+
+//constructor
+Snapshot::Snapshot(){
+	this->tick = 0;
+	this->sim_time = 0;
+	return;
+}
+void Snapshot::resize(int num_cells){
+	rank.resize(num_cells);
+	x.resize(num_cells);
+	y.resize(num_cells);
+	radius.resize(num_cells);
+	sector.resize(num_cells);
+	age.resize(num_cells);
+	T_age.resize(num_cells);
+	is_bud.resize(num_cells);
+	phase.resize(num_cells);
+	CP.resize(num_cells);
+	mother_rank.resize(num_cells);
+	protein.resize(num_cells);
+	bin_id.resize(num_cells);
+	four_lineage.resize(num_cells);
+	lineage_offsets.resize(num_cells+1);
+	g_lineage_offsets.resize(num_cells+1);
+	return;
+}
+void Snapshot::write_binary(ostream& os, bool full_precision) const{
+	//columns in the order they are listed and written
+	Column_Type real_type = full_precision ? FLOAT64_COLUMN : FLOAT32_COLUMN;
+	Out_Column columns[] = {
+		int_column("rank",rank),
+		real_column("x",x,real_type),
+		real_column("y",y,real_type),
+		real_column("radius",radius,real_type),
+		int_column("sector",sector),
+		int_column("age",age),
+		int_column("T_age",T_age),
+		byte_column("is_bud",is_bud),
+		byte_column("phase",phase),
+		real_column("CP",CP,real_type),
+		int_column("mother_rank",mother_rank),
+		real_column("protein",protein,real_type),
+		int_column("bin_id",bin_id),
+		int_column("four_lineage",four_lineage)
+	};
+	Out_Blob blobs[] = {
+		path_blob("g_lineage",g_lineage_offsets,g_lineage),
+		path_blob("lineage",lineage_offsets,lineage)
+	};
+	const uint32_t num_columns = sizeof(columns)/sizeof(columns[0]);
+	const uint32_t num_blobs = sizeof(blobs)/sizeof(blobs[0]);
+	//the header is padded like an array, so the first column is
+	//aligned whatever columns and blobs are listed
+	ostringstream header;
+	header.write(SNAPSHOT_MAGIC,sizeof(SNAPSHOT_MAGIC));
+	write_value<uint32_t>(header,SNAPSHOT_VERSION);
+	write_value<uint32_t>(header,0x01020304);
+	write_value<int64_t>(header,tick);
+	write_value<double>(header,sim_time);
+	write_value<uint64_t>(header,size());
+	write_value<uint32_t>(header,num_columns);
+	for(uint32_t i = 0; i < num_columns; i++){
+		write_name(header,columns[i].name);
+		write_value<uint32_t>(header,columns[i].type);
+	}
+	write_value<uint32_t>(header,num_blobs);
+	for(uint32_t i = 0; i < num_blobs; i++){
+		write_name(header,blobs[i].name);
+		write_value<uint32_t>(header,blobs[i].length_type);
+		write_value<uint32_t>(header,blobs[i].value_type);
+	}
+	string header_bytes = header.str();
+	os.write(header_bytes.data(),header_bytes.size());
+	write_padding(os,header_bytes.size());
+	for(uint32_t i = 0; i < num_columns; i++){
+		if(columns[i].bytes){
+			write_array(os,*columns[i].bytes);
+		}else if(columns[i].ints){
+			write_as(os,*columns[i].ints,columns[i].type);
+		}else{
+			write_as(os,*columns[i].reals,columns[i].type);
+		}
+	}
+	for(uint32_t i = 0; i < num_blobs; i++){
+		write_as(os,blobs[i].lengths,blobs[i].length_type);
+		write_as(os,*blobs[i].values,blobs[i].value_type);
+	}
+	return;
+}
+void Snapshot::write_text(ostream& os) const{
+	os << size() << '\n';
+	for(int i = 0; i < size(); i++){
+		os << rank[i] << " " << x[i] << " " << y[i] << " " << radius[i] << " ";
+		write_path(os,g_lineage_offsets,g_lineage,i);
+		os << " ";
+		write_path(os,lineage_offsets,lineage,i);
+		os << " " << sector[i] << " " << age[i] << " " << T_age[i] << " " << (int)is_bud[i] << " " << (int)phase[i] << " " << CP[i] << " " << mother_rank[i] << " " << protein[i] << " " << bin_id[i] << " " << four_lineage[i] << '\n';
+	}
+	return;
+}
+//****************************************
+//Public Member Functions for Snapshot_Writer
+
+//constructor
+Snapshot_Writer::Snapshot_Writer(Output_Format format, bool full_precision, unique_ptr<Output_Sink> sink, const string& prefix, int64_t first_tick){
+	this->format = format;
+	this->full_precision = full_precision;
+	this->sink = move(sink);
+	if(format == SERIES_OUTPUT){
+		series.reset(new Series_Encoder(prefix + ".series",first_tick));
+		if(!series->good()){
+			cout << "could not open " << series->get_filename() << endl;
+		}
+	}
+	this->done = false;
+	this->worker = thread(&Snapshot_Writer::run,this);
+	return;
+}
+Snapshot_Writer::~Snapshot_Writer(){
+	finish();
+	{
+		lock_guard<mutex> guard(queue_lock);
+		done = true;
+	}
+	queue_changed.notify_all();
+	worker.join();
+	if(series && !series->close()){
+		cout << "could not write " << series->get_filename() << endl;
+	}
+	return;
+}
+unique_ptr<Snapshot> Snapshot_Writer::get_buffer(){
+	lock_guard<mutex> guard(queue_lock);
+	if(spare.empty()){
+		return unique_ptr<Snapshot>(new Snapshot());
+	}
+	unique_ptr<Snapshot> frame = move(spare.back());
+	spare.pop_back();
+	return frame;
+}
+void Snapshot_Writer::submit(unique_ptr<Snapshot> frame, int number){
+	unique_lock<mutex> guard(queue_lock);
+	//a slow disk holds the simulation back rather than
+	//letting frames pile up in memory
+	queue_changed.wait(guard,[this]{return pending.size() < MAX_PENDING;});
+	pending.push_back(make_pair(move(frame),number));
+	guard.unlock();
+	queue_changed.notify_all();
+	return;
+}
+void Snapshot_Writer::finish(){
+	unique_lock<mutex> guard(queue_lock);
+	queue_changed.wait(guard,[this]{return pending.empty();});
+	return;
+}
+void Snapshot_Writer::run(){
+	unique_lock<mutex> guard(queue_lock);
+	while(true){
+		queue_changed.wait(guard,[this]{return done || !pending.empty();});
+		if(pending.empty()){
+			return;
+		}
+		//the frame stays queued while it is written so finish
+		//waits for it
+		Snapshot* frame = pending.front().first.get();
+		int number = pending.front().second;
+		guard.unlock();
+		if(format == SERIES_OUTPUT){
+			if(!series->write_frame(*frame)){
+				cout << "could not write " << series->get_filename() << endl;
+			}
+		}else{
+			ostream& os = sink->begin_frame(number);
+			if(format == SNAPSHOT_OUTPUT){
+				frame->write_binary(os,full_precision);
+			}else{
+				frame->write_text(os);
+			}
+			if(!sink->end_frame()){
+				cout << "could not write " << sink->get_name() << endl;
+			}
+		}
+		guard.lock();
+		spare.push_back(move(pending.front().first));
+		pending.pop_front();
+		queue_changed.notify_all();
+	}
+}
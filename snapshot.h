@@ -0,0 +1,142 @@
+//snapshot.h
+
+//*********************************************************
+// Include Guards
+#ifndef _SNAPSHOT_H_INCLUDED_
+#define _SNAPSHOT_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+class Series_Encoder;
+class Output_Sink;
+
+//*********************************************************
+// include dependencies
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+//*********************************************************
+//Binary snapshot layout, values in the writer's byte order:
+//  magic "YSNAPSHT", uint32 version, uint32 0x01020304 to tell
+//  which byte order that was
+//  int64 tick, float64 sim_time, uint64 num_cells
+//  uint32 num_columns, then per column char name[16], uint32 type
+//  uint32 num_blobs, then per blob char name[16], uint32 type of
+//  the lengths and uint32 type of the values
+//  each column as num_cells values of its type
+//  each blob as num_cells lengths and then the values, the values
+//  of cell i follow those of cells 0..i-1
+//The header and every array are zero padded to a multiple of 8
+//bytes so a mapped file can be read in place, see
+//snapshot_reader.h. Rows are in
+//rank order. Readers go by the column names, so columns can be
+//added without breaking old readers.
+//x, y, radius, CP and protein are float32 unless the run asks for
+//float64 with -snapshot_precision double. Integer columns and blobs
+//take the narrowest type that holds every value of the frame.
+const char SNAPSHOT_MAGIC[8] = {'Y','S','N','A','P','S','H','T'};
+const uint32_t SNAPSHOT_VERSION = 3;
+const int SNAPSHOT_ALIGNMENT = 8;
+const int SNAPSHOT_NAME_SIZE = 16;
+//column types, the low byte is the width in bytes
+enum Column_Type {
+	UINT8_COLUMN = 0x001, UINT16_COLUMN = 0x002, UINT32_COLUMN = 0x004,
+	INT8_COLUMN = 0x101, INT16_COLUMN = 0x102, INT32_COLUMN = 0x104,
+	FLOAT32_COLUMN = 0x204, FLOAT64_COLUMN = 0x208
+};
+inline int get_column_width(Column_Type type){return type & 0xFF;}
+inline bool is_column_type(uint32_t type){
+	return (type == UINT8_COLUMN) || (type == UINT16_COLUMN) || (type == UINT32_COLUMN) || (type == INT8_COLUMN) || (type == INT16_COLUMN) || (type == INT32_COLUMN) || (type == FLOAT32_COLUMN) || (type == FLOAT64_COLUMN);
+}
+//text and binary snapshots are a file per frame, a series
+//is every frame in one file, see series.h
+enum Output_Format {TEXT_OUTPUT, SNAPSHOT_OUTPUT, SERIES_OUTPUT};
+
+//*********************************************************
+// Snapshot Class Declaration
+
+//Copy of the per cell output of one frame, filled by
+//Colony::take_snapshot so it can be written while the
+//simulation moves on.
+class Snapshot {
+	public:
+		int64_t tick;
+		double sim_time;
+		vector<int32_t> rank;
+		vector<double> x;
+		vector<double> y;
+		vector<double> radius;
+		vector<int32_t> sector;
+		vector<int32_t> age;
+		vector<int32_t> T_age;
+		vector<uint8_t> is_bud;
+		vector<uint8_t> phase;
+		vector<double> CP;
+		vector<int32_t> mother_rank;
+		vector<double> protein;
+		vector<int32_t> bin_id;
+		vector<int32_t> four_lineage;
+		//lineages of cell i are lineage[lineage_offsets[i]..lineage_offsets[i+1])
+		vector<uint32_t> lineage_offsets;
+		vector<int32_t> lineage;
+		vector<uint32_t> g_lineage_offsets;
+		vector<int32_t> g_lineage;
+	public:
+		//constructor
+		Snapshot();
+		void resize(int num_cells);
+		int size() const {return rank.size();}
+		//float64 columns are written as float32 unless
+		//full_precision is set
+		void write_binary(ostream& os, bool full_precision) const;
+		//same lines the text output has always had
+		void write_text(ostream& os) const;
+};
+
+//End Snapshot Class
+//**************************************************************
+// Snapshot_Writer Class Declaration
+
+//Writes snapshots from a background thread. The simulation gets
+//a buffer, fills it and hands it back with its frame number,
+//written buffers are reused. At most MAX_PENDING frames wait at
+//a time. Text and binary frames go to an Output_Sink, a series
+//is always a file.
+class Snapshot_Writer {
+	private:
+		static const unsigned int MAX_PENDING = 4;
+		Output_Format format;
+		bool full_precision;
+		unique_ptr<Output_Sink> sink;
+		unique_ptr<Series_Encoder> series;
+		bool done;
+		deque<pair<unique_ptr<Snapshot>,int>> pending;
+		vector<unique_ptr<Snapshot>> spare;
+		mutex queue_lock;
+		condition_variable queue_changed;
+		thread worker;
+		void run();
+	public:
+		//constructor, text and binary frames go to sink, a
+		//series to prefix.series, which carries on from first_tick.
+		//full_precision keeps binary frames in float64
+		Snapshot_Writer(Output_Format format, bool full_precision, unique_ptr<Output_Sink> sink, const string& prefix, int64_t first_tick);
+		~Snapshot_Writer();
+		unique_ptr<Snapshot> get_buffer();
+		void submit(unique_ptr<Snapshot> frame, int number);
+		//returns once every submitted frame is on disk
+		void finish();
+};
+
+//End Snapshot_Writer Class
+//**************************************************************
+#endif
+
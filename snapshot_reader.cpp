@@ -0,0 +1,278 @@
+//snapshot_reader.cpp
+
+//******************************************
+//Include Dependencies
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "snapshot_reader.h"
+using namespace std;
+//******************************************
+//header helpers, each checks the read stays in the file
+
+static bool read_bytes(const char* data, size_t length, size_t& pos, void* value, size_t size){
+	if(size > length - pos){
+		return false;
+	}
+	memcpy(value,data + pos,size);
+	pos += size;
+	return true;
+}
+static bool read_name(const char* data, size_t length, size_t& pos, string& name){
+	char padded[SNAPSHOT_NAME_SIZE+1];
+	if(!read_bytes(data,length,pos,padded,SNAPSHOT_NAME_SIZE)){
+		return false;
+	}
+	padded[SNAPSHOT_NAME_SIZE] = '\0';
+	name = padded;
+	return true;
+}
+//start of the next array, arrays are padded as the writer pads them
+static size_t skip_array(size_t pos, size_t bytes){
+	pos += bytes;
+	return pos + (SNAPSHOT_ALIGNMENT - pos%SNAPSHOT_ALIGNMENT)%SNAPSHOT_ALIGNMENT;
+}
+//type of column each reader type matches
+static Column_Type type_of(const uint8_t*){return UINT8_COLUMN;}
+static Column_Type type_of(const uint16_t*){return UINT16_COLUMN;}
+static Column_Type type_of(const uint32_t*){return UINT32_COLUMN;}
+static Column_Type type_of(const int8_t*){return INT8_COLUMN;}
+static Column_Type type_of(const int16_t*){return INT16_COLUMN;}
+static Column_Type type_of(const int32_t*){return INT32_COLUMN;}
+static Column_Type type_of(const float*){return FLOAT32_COLUMN;}
+static Column_Type type_of(const double*){return FLOAT64_COLUMN;}
+template<typename R>
+static R read_number(const char* values, Column_Type type, size_t i){
+	switch(type){
+		case UINT8_COLUMN: return (R)((const uint8_t*)values)[i];
+		case UINT16_COLUMN: return (R)((const uint16_t*)values)[i];
+		case UINT32_COLUMN: return (R)((const uint32_t*)values)[i];
+		case INT8_COLUMN: return (R)((const int8_t*)values)[i];
+		case INT16_COLUMN: return (R)((const int16_t*)values)[i];
+		case INT32_COLUMN: return (R)((const int32_t*)values)[i];
+		case FLOAT32_COLUMN: return (R)((const float*)values)[i];
+		case FLOAT64_COLUMN: return (R)((const double*)values)[i];
+	}
+	return 0;
+}
+//****************************************
+//Public Member Functions for Number_View
+
+int64_t Number_View::get_int(size_t i) const{
+	return read_number<int64_t>(values,type,i);
+}
+double Number_View::get_double(size_t i) const{
+	return read_number<double>(values,type,i);
+}
+//****************************************
+//Public Member Functions for Snapshot_Map
+
+//constructor
+Snapshot_Map::Snapshot_Map(const string& filename){
+	this->data = NULL;
+	this->length = 0;
+	this->tick = 0;
+	this->sim_time = 0;
+	this->num_cells = 0;
+	this->ok = false;
+	int fd = open(filename.c_str(),O_RDONLY);
+	if(fd < 0){
+		return;
+	}
+	struct stat info;
+	if((fstat(fd,&info) == 0) && (info.st_size > 0)){
+		void* mapped = mmap(NULL,info.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+		if(mapped != MAP_FAILED){
+			data = (const char*)mapped;
+			length = info.st_size;
+		}
+	}
+	//the mapping holds its own reference to the file
+	close(fd);
+	if(data != NULL){
+		ok = parse();
+	}
+	return;
+}
+Snapshot_Map::~Snapshot_Map(){
+	if(data != NULL){
+		munmap((void*)data,length);
+	}
+	return;
+}
+string Snapshot_Map::get_filename(const string& folder, int n){
+	return folder + "/locations" + to_string(n) + ".snap";
+}
+Column_Type Snapshot_Map::get_column_type(const string& name) const{
+	return columns.at(name).type;
+}
+template<typename T>
+Column_View<T> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const{
+	map<string,Column>::const_iterator found = columns.find(name);
+	if((found == columns.end()) || (found->second.type != type_of((const T*)NULL))){
+		return Column_View<T>();
+	}
+	last = min(last,num_cells);
+	if(first >= last){
+		return Column_View<T>();
+	}
+	return Column_View<T>((const T*)(data + found->second.offset) + first,last - first);
+}
+template Column_View<uint8_t> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+template Column_View<uint16_t> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+template Column_View<uint32_t> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+template Column_View<int8_t> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+template Column_View<int16_t> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+template Column_View<int32_t> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+template Column_View<float> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+template Column_View<double> Snapshot_Map::get_column(const string& name, uint64_t first, uint64_t last) const;
+Number_View Snapshot_Map::get_numbers(const string& name, uint64_t first, uint64_t last) const{
+	map<string,Column>::const_iterator found = columns.find(name);
+	if(found == columns.end()){
+		return Number_View();
+	}
+	last = min(last,num_cells);
+	if(first >= last){
+		return Number_View();
+	}
+	return Number_View(data + found->second.offset,found->second.type,num_cells).slice(first,last);
+}
+Number_View Snapshot_Map::get_path(const string& name, uint64_t cell) const{
+	map<string,Blob>::const_iterator found = blobs.find(name);
+	if((found == blobs.end()) || (cell >= num_cells)){
+		return Number_View();
+	}
+	const vector<uint32_t>& offsets = found->second.offsets;
+	return get_path_values(name).slice(offsets[cell],offsets[cell+1]);
+}
+Column_View<uint32_t> Snapshot_Map::get_path_offsets(const string& name) const{
+	map<string,Blob>::const_iterator found = blobs.find(name);
+	if(found == blobs.end()){
+		return Column_View<uint32_t>();
+	}
+	return Column_View<uint32_t>(found->second.offsets.data(),num_cells+1);
+}
+Number_View Snapshot_Map::get_path_values(const string& name) const{
+	map<string,Blob>::const_iterator found = blobs.find(name);
+	if(found == blobs.end()){
+		return Number_View();
+	}
+	return Number_View(data + found->second.values,found->second.type,found->second.offsets[num_cells]);
+}
+//****************************************
+//Private Member Functions for Snapshot_Map
+
+//reads the header and works out where every array starts, the
+//arrays themselves are only touched when a reader asks for them
+bool Snapshot_Map::parse(){
+	size_t pos = 0;
+	char magic[sizeof(SNAPSHOT_MAGIC)];
+	uint32_t version = 0;
+	uint32_t byte_order = 0;
+	if(!read_bytes(data,length,pos,magic,sizeof(magic)) || memcmp(magic,SNAPSHOT_MAGIC,sizeof(magic))){
+		return false;
+	}
+	if(!read_bytes(data,length,pos,&version,sizeof(version)) || !read_bytes(data,length,pos,&byte_order,sizeof(byte_order))){
+		return false;
+	}
+	if((version != SNAPSHOT_VERSION) || (byte_order != 0x01020304)){
+		return false;
+	}
+	if(!read_bytes(data,length,pos,&tick,sizeof(tick)) || !read_bytes(data,length,pos,&sim_time,sizeof(sim_time))){
+		return false;
+	}
+	if(!read_bytes(data,length,pos,&num_cells,sizeof(num_cells)) || (num_cells > length)){
+		return false;
+	}
+	uint32_t num_columns = 0;
+	if(!read_bytes(data,length,pos,&num_columns,sizeof(num_columns))){
+		return false;
+	}
+	vector<Column_Type> types;
+	for(uint32_t i = 0; i < num_columns; i++){
+		string name;
+		uint32_t type = 0;
+		if(!read_name(data,length,pos,name) || !read_bytes(data,length,pos,&type,sizeof(type))){
+			return false;
+		}
+		if(!is_column_type(type)){
+			return false;
+		}
+		column_names.push_back(name);
+		types.push_back((Column_Type)type);
+	}
+	uint32_t num_blobs = 0;
+	if(!read_bytes(data,length,pos,&num_blobs,sizeof(num_blobs))){
+		return false;
+	}
+	//blob lengths are unsigned and values are integers
+	vector<Column_Type> length_types;
+	vector<Column_Type> value_types;
+	for(uint32_t i = 0; i < num_blobs; i++){
+		string name;
+		uint32_t length_type = 0;
+		uint32_t value_type = 0;
+		if(!read_name(data,length,pos,name) || !read_bytes(data,length,pos,&length_type,sizeof(length_type)) || !read_bytes(data,length,pos,&value_type,sizeof(value_type))){
+			return false;
+		}
+		if((length_type != UINT8_COLUMN) && (length_type != UINT16_COLUMN) && (length_type != UINT32_COLUMN)){
+			return false;
+		}
+		if(!is_column_type(value_type) || (value_type == FLOAT32_COLUMN) || (value_type == FLOAT64_COLUMN)){
+			return false;
+		}
+		blob_names.push_back(name);
+		length_types.push_back((Column_Type)length_type);
+		value_types.push_back((Column_Type)value_type);
+	}
+	//bounds are checked against the file size so a truncated
+	//frame is rejected rather than read past its end, the header
+	//is padded as the writer pads an array
+	pos = skip_array(pos,0);
+	for(uint32_t i = 0; i < num_columns; i++){
+		Column column;
+		column.type = types[i];
+		column.offset = pos;
+		pos = skip_array(pos,num_cells*get_column_width(types[i]));
+		if(pos > length){
+			return false;
+		}
+		columns[column_names[i]] = column;
+	}
+	for(uint32_t i = 0; i < num_blobs; i++){
+		//paths are handed out from the offsets, so the lengths
+		//are summed here and the values must hold them all
+		size_t lengths = pos;
+		pos = skip_array(pos,num_cells*get_column_width(length_types[i]));
+		if(pos > length){
+			return false;
+		}
+		Number_View path_lengths(data + lengths,length_types[i],num_cells);
+		Blob blob;
+		blob.offsets.resize(num_cells+1);
+		blob.offsets[0] = 0;
+		uint64_t num_values = 0;
+		for(uint64_t k = 0; k < num_cells; k++){
+			num_values += path_lengths.get_int(k);
+			if((num_values > length) || (num_values > UINT32_MAX)){
+				return false;
+			}
+			blob.offsets[k+1] = num_values;
+		}
+		blob.type = value_types[i];
+		blob.values = pos;
+		pos = skip_array(pos,num_values*get_column_width(value_types[i]));
+		if(pos > length){
+			return false;
+		}
+		blobs[blob_names[i]] = blob;
+	}
+	return true;
+}
@@ -0,0 +1,126 @@
+//snapshot_reader.h
+
+//*********************************************************
+// Include Guards
+#ifndef _SNAPSHOT_READER_H_INCLUDED_
+#define _SNAPSHOT_READER_H_INCLUDED_
+
+//*********************************************************
+// forward declarations
+
+//*********************************************************
+// include dependencies
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "snapshot.h"
+
+using namespace std;
+//*********************************************************
+//Reads binary snapshots (-output_format binary) in place. The
+//file is memory mapped and columns come back as views into the
+//mapping, so only the pages a reader touches are read from disk.
+//A view is valid while its Snapshot_Map is alive.
+
+template<typename T>
+class Column_View {
+	private:
+		const T* values;
+		size_t count;
+	public:
+		//constructor
+		Column_View() : values(NULL), count(0) {}
+		Column_View(const T* values, size_t count) : values(values), count(count) {}
+		size_t size() const {return count;}
+		bool empty() const {return count == 0;}
+		const T& operator[](size_t i) const {return values[i];}
+		const T* begin() const {return values;}
+		const T* end() const {return values + count;}
+};
+
+//A column or path of any type, values are widened as they are
+//read so a reader need not care which width a frame picked.
+class Number_View {
+	private:
+		const char* values;
+		Column_Type type;
+		size_t count;
+	public:
+		//constructor
+		Number_View() : values(NULL), type(INT32_COLUMN), count(0) {}
+		Number_View(const void* values, Column_Type type, size_t count) : values((const char*)values), type(type), count(count) {}
+		size_t size() const {return count;}
+		bool empty() const {return count == 0;}
+		Column_Type get_type() const {return type;}
+		bool is_float() const {return (type == FLOAT32_COLUMN) || (type == FLOAT64_COLUMN);}
+		int64_t get_int(size_t i) const;
+		double get_double(size_t i) const;
+		//values [first,last)
+		Number_View slice(size_t first, size_t last) const {return Number_View(values + first*get_column_width(type),type,last - first);}
+};
+
+//*********************************************************
+// Snapshot_Map Class Declaration
+
+class Snapshot_Map {
+	private:
+		struct Column {
+			Column_Type type;
+			size_t offset;
+		};
+		//the lengths are summed into offsets when the file is
+		//parsed
+		struct Blob {
+			vector<uint32_t> offsets;
+			Column_Type type;
+			size_t values;
+		};
+		const char* data;
+		size_t length;
+		int64_t tick;
+		double sim_time;
+		uint64_t num_cells;
+		vector<string> column_names;
+		map<string,Column> columns;
+		vector<string> blob_names;
+		map<string,Blob> blobs;
+		bool ok;
+		bool parse();
+		//no copies, the views point into the mapping
+		Snapshot_Map(const Snapshot_Map&);
+		Snapshot_Map& operator=(const Snapshot_Map&);
+	public:
+		//constructor, maps and checks the file
+		Snapshot_Map(const string& filename);
+		~Snapshot_Map();
+		//frame n of a run written to folder
+		static string get_filename(const string& folder, int n);
+		bool good() const {return ok;}
+		int64_t get_tick() const {return tick;}
+		double get_sim_time() const {return sim_time;}
+		uint64_t size() const {return num_cells;}
+		const vector<string>& get_column_names() const {return column_names;}
+		const vector<string>& get_blob_names() const {return blob_names;}
+		bool has_column(const string& name) const {return columns.count(name) > 0;}
+		bool has_blob(const string& name) const {return blobs.count(name) > 0;}
+		Column_Type get_column_type(const string& name) const;
+		//rows [first,last) of a column, empty if the column is
+		//missing or is not of type T
+		template<typename T> Column_View<T> get_column(const string& name, uint64_t first, uint64_t last) const;
+		template<typename T> Column_View<T> get_column(const string& name) const {return get_column<T>(name,0,num_cells);}
+		//rows [first,last) of a column whatever its type
+		Number_View get_numbers(const string& name, uint64_t first, uint64_t last) const;
+		//values of one cell in a blob, e.g. its lineage path
+		Number_View get_path(const string& name, uint64_t cell) const;
+		//a whole blob, the values of cell i run from offsets[i]
+		//to offsets[i+1]
+		Column_View<uint32_t> get_path_offsets(const string& name) const;
+		Number_View get_path_values(const string& name) const;
+};
+
+//End Snapshot_Map Class
+//**************************************************************
+#endif
+
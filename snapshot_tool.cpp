@@ -0,0 +1,270 @@
+//snapshot_tool.cpp
+
+//******************************************
+//Include Dependencies
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "snapshot_reader.h"
+#include "series.h"
+
+using namespace std;
+
+//Dumps binary snapshots written with -output_format binary or
+//series.
+//  snapshot_tool PATH [-frame N] [-frames A B] [-tick T]
+//                [-cells A B] [-columns rank,x,y] [-info]
+//PATH is a .snap or .series file or the output folder of a run.
+//Frames A..B are read, all of them by default. -tick seeks a
+//series to its first frame at or after tick T. Each frame is
+//printed as the text output has it, a line with the number of rows
+//then a row per cell, so a whole frame is its locations<N>.txt.
+//-cells picks cells [A,B) and -columns picks columns. -info prints
+//the header of each frame instead of its rows.
+
+static const char* TEXT_COLUMNS = "rank,x,y,radius,g_lineage,lineage,sector,age,T_age,is_bud,phase,CP,mother_rank,protein,bin_id,four_lineage";
+
+static void print_usage(){
+	cerr << "usage: snapshot_tool PATH [-frame N] [-frames A B] [-tick T] [-cells A B] [-columns c1,c2,...] [-info]" << endl;
+	return;
+}
+static const char* get_type_name(Column_Type type){
+	switch(type){
+		case UINT8_COLUMN: return "uint8";
+		case UINT16_COLUMN: return "uint16";
+		case UINT32_COLUMN: return "uint32";
+		case INT8_COLUMN: return "int8";
+		case INT16_COLUMN: return "int16";
+		case INT32_COLUMN: return "int32";
+		case FLOAT32_COLUMN: return "float32";
+		case FLOAT64_COLUMN: return "float64";
+	}
+	return "unknown";
+}
+static void print_info(int n, const Snapshot_Map& frame){
+	cout << "frame " << n << " tick " << frame.get_tick() << " sim_time " << frame.get_sim_time() << " cells " << frame.size() << endl;
+	const vector<string>& names = frame.get_column_names();
+	for(unsigned int i = 0; i < names.size(); i++){
+		cout << "  column " << names[i] << " " << get_type_name(frame.get_column_type(names[i])) << endl;
+	}
+	const vector<string>& blobs = frame.get_blob_names();
+	for(unsigned int i = 0; i < blobs.size(); i++){
+		cout << "  path " << blobs[i] << " " << get_type_name(frame.get_path_values(blobs[i]).get_type()) << endl;
+	}
+	return;
+}
+//views of one selected column over the printed cells, a path has
+//the offsets of those cells and one more
+struct Selected {
+	string name;
+	bool path;
+	Number_View numbers;
+	Column_View<uint32_t> offsets;
+	Number_View values;
+};
+static bool select_columns(const Snapshot_Map& frame, const vector<string>& names, uint64_t first, uint64_t last, vector<Selected>& selected){
+	selected.resize(names.size());
+	for(unsigned int j = 0; j < names.size(); j++){
+		Selected& column = selected[j];
+		column.name = names[j];
+		column.path = frame.has_blob(names[j]);
+		if(column.path){
+			Column_View<uint32_t> offsets = frame.get_path_offsets(names[j]);
+			column.offsets = Column_View<uint32_t>(offsets.begin() + first,last - first + 1);
+			column.values = frame.get_path_values(names[j]);
+			continue;
+		}
+		if(!frame.has_column(names[j])){
+			cerr << "no column " << names[j] << endl;
+			return false;
+		}
+		column.numbers = frame.get_numbers(names[j],first,last);
+	}
+	return true;
+}
+//a decoded series frame holds the same columns in vectors
+static Column_View<uint32_t> get_slice(const vector<uint32_t>& values, uint64_t first, uint64_t last){
+	return Column_View<uint32_t>(values.data() + first,last - first);
+}
+template<typename T>
+static Number_View get_numbers(const vector<T>& values, Column_Type type, uint64_t first, uint64_t last){
+	return Number_View(values.data(),type,values.size()).slice(first,last);
+}
+static bool select_columns(const Snapshot& frame, const vector<string>& names, uint64_t first, uint64_t last, vector<Selected>& selected){
+	selected.resize(names.size());
+	for(unsigned int j = 0; j < names.size(); j++){
+		Selected& column = selected[j];
+		const string& name = names[j];
+		column.name = name;
+		column.path = (name == "g_lineage") || (name == "lineage");
+		if(name == "g_lineage"){
+			column.offsets = get_slice(frame.g_lineage_offsets,first,last+1);
+			column.values = get_numbers(frame.g_lineage,INT32_COLUMN,0,frame.g_lineage.size());
+		}else if(name == "lineage"){
+			column.offsets = get_slice(frame.lineage_offsets,first,last+1);
+			column.values = get_numbers(frame.lineage,INT32_COLUMN,0,frame.lineage.size());
+		}else if((name == "is_bud") || (name == "phase")){
+			column.numbers = get_numbers(name == "is_bud" ? frame.is_bud : frame.phase,UINT8_COLUMN,first,last);
+		}else if((name == "x") || (name == "y") || (name == "radius") || (name == "CP") || (name == "protein")){
+			const vector<double>& values = (name == "x") ? frame.x : (name == "y") ? frame.y : (name == "radius") ? frame.radius : (name == "CP") ? frame.CP : frame.protein;
+			column.numbers = get_numbers(values,FLOAT64_COLUMN,first,last);
+		}else if((name == "rank") || (name == "sector") || (name == "age") || (name == "T_age") || (name == "mother_rank") || (name == "bin_id") || (name == "four_lineage")){
+			const vector<int32_t>& values = (name == "rank") ? frame.rank : (name == "sector") ? frame.sector : (name == "age") ? frame.age : (name == "T_age") ? frame.T_age : (name == "mother_rank") ? frame.mother_rank : (name == "bin_id") ? frame.bin_id : frame.four_lineage;
+			column.numbers = get_numbers(values,INT32_COLUMN,first,last);
+		}else{
+			cerr << "no column " << name << endl;
+			return false;
+		}
+	}
+	return true;
+}
+static void print_rows(const vector<Selected>& selected, uint64_t num_rows){
+	cout << num_rows << '\n';
+	for(uint64_t i = 0; i < num_rows; i++){
+		for(unsigned int j = 0; j < selected.size(); j++){
+			const Selected& column = selected[j];
+			if(j > 0){
+				cout << " ";
+			}
+			if(column.path){
+				for(uint32_t k = column.offsets[i]; k < column.offsets[i+1]; k++){
+					cout << "/" << column.values.get_int(k);
+				}
+			}else if(column.numbers.is_float()){
+				cout << column.numbers.get_double(i);
+			}else{
+				cout << column.numbers.get_int(i);
+			}
+		}
+		cout << '\n';
+	}
+	return;
+}
+//frames are decoded in order, a seek starts from the keyframe
+//at or before the tick
+static int dump_series(const string& filename, int first_frame, int last_frame, int64_t tick, uint64_t first_cell, uint64_t last_cell, const vector<string>& names, bool info){
+	Series_Decoder decoder(filename);
+	if(!decoder.good()){
+		cerr << "could not read " << filename << endl;
+		return 1;
+	}
+	if((tick >= 0) && !decoder.seek(tick)){
+		cerr << "no keyframe at or before tick " << tick << " in " << filename << endl;
+		return 1;
+	}
+	Snapshot frame;
+	vector<Selected> selected;
+	for(int n = 1; decoder.read_frame(frame); n++){
+		if(tick >= 0){
+			if(frame.tick < tick){
+				continue;
+			}
+			first_frame = last_frame = n;
+		}
+		if(n < first_frame){
+			continue;
+		}
+		if(info){
+			//frames are only counted from the start of the file
+			if(tick < 0){
+				cout << "frame " << n << " ";
+			}
+			cout << "tick " << frame.tick << " sim_time " << frame.sim_time << " cells " << frame.size() << endl;
+		}else{
+			uint64_t last = min(last_cell,(uint64_t)frame.size());
+			uint64_t first = min(first_cell,last);
+			if(!select_columns(frame,names,first,last,selected)){
+				return 1;
+			}
+			print_rows(selected,last - first);
+		}
+		if(n == last_frame){
+			break;
+		}
+	}
+	return 0;
+}
+int main(int argc, char* argv[]){
+	if(argc < 2){
+		print_usage();
+		return 1;
+	}
+	string path = argv[1];
+	int first_frame = 1;
+	int last_frame = -1;
+	uint64_t first_cell = 0;
+	uint64_t last_cell = UINT64_MAX;
+	string column_list = TEXT_COLUMNS;
+	bool info = false;
+	int64_t tick = -1;
+	for(int i = 2; i < argc; i++){
+		if(!strcmp(argv[i],"-frame") && (i+1 < argc)){
+			first_frame = last_frame = atoi(argv[++i]);
+		}else if(!strcmp(argv[i],"-frames") && (i+2 < argc)){
+			first_frame = atoi(argv[++i]);
+			last_frame = atoi(argv[++i]);
+		}else if(!strcmp(argv[i],"-tick") && (i+1 < argc)){
+			tick = atoll(argv[++i]);
+		}else if(!strcmp(argv[i],"-cells") && (i+2 < argc)){
+			first_cell = strtoull(argv[++i],NULL,10);
+			last_cell = strtoull(argv[++i],NULL,10);
+		}else if(!strcmp(argv[i],"-columns") && (i+1 < argc)){
+			column_list = argv[++i];
+		}else if(!strcmp(argv[i],"-info")){
+			info = true;
+		}else{
+			print_usage();
+			return 1;
+		}
+	}
+	vector<string> names;
+	stringstream columns(column_list);
+	string name;
+	while(getline(columns,name,',')){
+		names.push_back(name);
+	}
+	//a single file, or frames of a run folder until one is missing
+	struct stat path_info;
+	bool folder = (stat(path.c_str(),&path_info) == 0) && S_ISDIR(path_info.st_mode);
+	string series_file = folder ? path + "/locations.series" : path;
+	if((series_file.size() >= 7) && (series_file.compare(series_file.size()-7,7,".series") == 0) && (stat(series_file.c_str(),&path_info) == 0)){
+		return dump_series(series_file,first_frame,last_frame,tick,first_cell,last_cell,names,info);
+	}
+	if(tick >= 0){
+		cerr << "-tick needs a series" << endl;
+		return 1;
+	}
+	if(!folder){
+		first_frame = last_frame = 0;
+	}
+	vector<Selected> selected;
+	for(int n = first_frame; (last_frame < 0) || (n <= last_frame); n++){
+		string filename = folder ? Snapshot_Map::get_filename(path,n) : path;
+		struct stat file_info;
+		if((last_frame < 0) && (stat(filename.c_str(),&file_info) != 0)){
+			break;
+		}
+		Snapshot_Map frame(filename);
+		if(!frame.good()){
+			cerr << "could not read " << filename << endl;
+			return 1;
+		}
+		if(info){
+			print_info(n,frame);
+			continue;
+		}
+		uint64_t last = min(last_cell,frame.size());
+		uint64_t first = min(first_cell,last);
+		if(!select_columns(frame,names,first,last,selected)){
+			return 1;
+		}
+		print_rows(selected,last - first);
+	}
+	return 0;
+}